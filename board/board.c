@@ -50,7 +50,7 @@ void BOARD_InitDebugConsole(void)
      *  10: OSCERCLK
      *  11: MCGIRCCLK
      */
-    CLOCK_SetLpsci0Clock(1);
+    CLOCK_SetLpsci0Clock(2);  // OSCERCLK, see BOARD_DEBUG_UART_CLKSRC
 
     uartClkSrcFreq = BOARD_DEBUG_UART_CLK_FREQ;
     DbgConsole_Init(BOARD_DEBUG_UART_BASEADDR, BOARD_DEBUG_UART_BAUDRATE, BOARD_DEBUG_UART_TYPE, uartClkSrcFreq);
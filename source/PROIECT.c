@@ -5,6 +5,7 @@
 #include "clock_config.h"
 #include "fsl_debug_console.h"
 #include "uart.h"
+#include "log.h"
 
 // Uncomment one of these to run a specific test
 //#define TEST_LDR_LED
@@ -20,14 +21,45 @@
 #include "ultrasonic.h"
 #include "bluetooth.h"
 #include "car_fsm.h"
+#include "fmt.h"
+#include "msg.h"
+#include "tick.h"
+#include "timebase.h"
+#include "swtimer.h"
+#include "prof.h"
+#include "events.h"
+#include "scheduler.h"
+#include "power.h"
+#include "ttc.h"
 
 // Configuration
-#define OBSTACLE_THRESHOLD_CM   20      // Stop if obstacle closer than 20cm
+#define OBSTACLE_THRESHOLD_CM   20      // Ultrasonic test mode marker (driving stops by TTC, see ttc.h)
+#define OBSTACLE_MIN_CONFIDENCE 50U     // Filtered distance confidence (0-100) to act on; <= the
+                                        // filter's relock confidence (50) or a new target waits a ping
 #define AUTO_LIGHTS_ENABLED     1       // 1 = auto lights on by default
+#define COMMAND_TIMEOUT_MS      0U      // Stop if no movement command for this long (0 = off)
+
+// Task periods / deadlines (ms) for the scheduler
+#define OBSTACLE_PERIOD_MS      10U     // Checks the 20Hz background ranging
+#define OBSTACLE_DEADLINE_MS    5U
+#define OBSTACLE_MAX_AGE_US     (2U * ULTRASONIC_RANGING_PERIOD_MS * 1000U)  // Older pings are stale
+#define LIGHTS_PERIOD_MS        200U    // 5Hz
+#define LIGHTS_DEADLINE_MS      100U
+#define CLIMATE_PERIOD_MS       2000U   // 0.5Hz (DHT11 needs >= 1s between reads)
+#define CLIMATE_DEADLINE_MS     1000U
+#define COMMANDS_DEADLINE_MS    20U
 
 // Global state (separate from FSM - for lights only)
 static uint8_t autoLightsMode = AUTO_LIGHTS_ENABLED;
 
+// Last DHT11 reading (Task_Climate), reported by SendSensorInfo
+static DHT11_ErrorCode climateStatus = DHT11_NO_DATA_0;
+static uint16_t climateTemperature = 0;
+static uint16_t climateHumidity = 0;
+
+// Dead-man timeout for movement commands (COMMAND_TIMEOUT_MS)
+static SwTimer_t commandTimeout;
+
 // Function prototypes
 void run_main_application(void);
 void run_test_ldr_led(void);
@@ -46,6 +78,10 @@ int main(void)
     
     // Initialize debug console (UART0 for printf and Bluetooth)
     BOARD_InitDebugConsole();
+    UART_TxInit();      // Interrupt-driven TX from here on
+    Timebase_Init();    // 1us PIT timebase (delays, timeouts, event timestamps)
+    Tick_Init();        // 1ms SysTick (scheduler)
+    Log_Init();         // Debug diagnostics off the Bluetooth link
 
 #ifdef TEST_LDR_LED
     run_test_ldr_led();
@@ -91,8 +127,8 @@ void run_test_ldr_led(void)
 
         Lights_Auto(val);
 
-        // Delay ~500ms between readings
-        for (volatile uint32_t i = 0; i < 2400000; i++);
+        // Delay 500ms between readings
+        Timebase_DelayMs(500);
     }
 }
 
@@ -134,17 +170,11 @@ void run_test_dht11(void)
             UART_SendString(") ---\r\n");
             
             UART_SendString("Temperature: ");
-            UART_SendNumber(temperature / 100);
-            UART_SendString(".");
-            if ((temperature % 100) < 10) UART_SendString("0");
-            UART_SendNumber(temperature % 100);
+            UART_SendCenti(temperature);
             UART_SendString(" C\r\n");
             
             UART_SendString("Humidity:    ");
-            UART_SendNumber(humidity / 100);
-            UART_SendString(".");
-            if ((humidity % 100) < 10) UART_SendString("0");
-            UART_SendNumber(humidity % 100);
+            UART_SendCenti(humidity);
             UART_SendString(" %\r\n");
             UART_SendString("Status:      VALID\r\n\r\n");
             
@@ -175,74 +205,21 @@ void run_test_dht11(void)
         }
         
         // DHT11 requires minimum 2 seconds between readings
-        // Delay approximately 2.5 seconds
-        for (volatile uint32_t i = 0; i < 50; i++) {
-            for (volatile uint32_t j = 0; j < 1000000; j++);
-        }
+        // Delay 2.5 seconds
+        Timebase_DelayMs(2500);
     }
 }
 
 
-// PIT turn timer for motor test
+// Turn duration for motor test
 #define TEST_TURN_DURATION_MS  400U   // 0.4 seconds for ~90 degree turn
-static volatile bool g_testTurnComplete = false;
 
 /**
- * @brief Initialize PIT channel 1 for motor test turn timing
- */
-static void TestTurnTimer_Init(void)
-{
-    // Enable PIT clock (may already be enabled)
-    SIM->SCGC6 |= SIM_SCGC6_PIT_MASK;
-    
-    // Enable PIT module
-    PIT->MCR = 0;
-    
-    // Disable PIT1 initially
-    PIT->CHANNEL[1].TCTRL = 0;
-    
-    // Enable PIT interrupt in NVIC
-    NVIC_EnableIRQ(PIT_IRQn);
-    NVIC_SetPriority(PIT_IRQn, 2);
-}
-
-/**
- * @brief Start one-shot turn timer on PIT channel 1
- */
-static void TestTurnTimer_Start(void)
-{
-    uint32_t busClk = CLOCK_GetBusClkFreq();
-    uint32_t loadVal = (busClk / 1000) * TEST_TURN_DURATION_MS - 1;
-    
-    g_testTurnComplete = false;
-    
-    // Configure PIT1
-    PIT->CHANNEL[1].LDVAL = loadVal;
-    PIT->CHANNEL[1].TFLG = PIT_TFLG_TIF_MASK;  // Clear any pending flag
-    PIT->CHANNEL[1].TCTRL = PIT_TCTRL_TIE_MASK | PIT_TCTRL_TEN_MASK;  // Enable timer + interrupt
-}
-
-/**
- * @brief PIT1 interrupt handler for motor test turns
- * Note: This will be called from PIT_IRQHandler - check for channel 1
- */
-void TestTurnTimer_IRQHandler(void)
-{
-    if (PIT->CHANNEL[1].TFLG & PIT_TFLG_TIF_MASK) {
-        PIT->CHANNEL[1].TFLG = PIT_TFLG_TIF_MASK;  // Clear flag
-        PIT->CHANNEL[1].TCTRL = 0;  // Disable timer (one-shot)
-        g_testTurnComplete = true;
-    }
-}
-
-/**
- * @brief Wait for turn to complete (non-blocking poll)
+ * @brief Hold the current turn for TEST_TURN_DURATION_MS, then stop
  */
 static void WaitForTurnComplete(void)
 {
-    while (!g_testTurnComplete) {
-        // Just wait - interrupt will set the flag
-    }
+    Timebase_DelayMs(TEST_TURN_DURATION_MS);
     Motor_Stop();
     UART_SendString("Turn complete!\r\n");
 }
@@ -255,43 +232,40 @@ void run_test_motors(void)
     UART_SendString("Motor Test Starting...\r\n");
     
     Motor_Init();
-    TestTurnTimer_Init();
     
     while (1) {
         UART_SendString("Forward... (10s)\r\n");
         Motor_Forward(100); 
-        for (volatile uint32_t i = 0; i < 24000000; i++);  // ~10 seconds
+        Timebase_DelayMs(10000);
         
         UART_SendString("Stop... (5s)\r\n");
         Motor_Stop();
-        for (volatile uint32_t i = 0; i < 12000000; i++);  // ~5 seconds
+        Timebase_DelayMs(5000);
         
         UART_SendString("Backward... (10s)\r\n");
         Motor_Backward(100);
-        for (volatile uint32_t i = 0; i < 24000000; i++);
+        Timebase_DelayMs(10000);
         
         UART_SendString("Stop... (5s)\r\n");
         Motor_Stop();
-        for (volatile uint32_t i = 0; i < 12000000; i++);
+        Timebase_DelayMs(5000);
         
-        // === Turn Left using PIT timer ===
-        UART_SendString("Turn Left... (PIT timer)\r\n");
+        // === Turn Left (timebase) ===
+        UART_SendString("Turn Left... (timebase)\r\n");
         Motor_TurnLeft(100);
-        TestTurnTimer_Start();
         WaitForTurnComplete();
         
         UART_SendString("Stop... (2s)\r\n");
-        for (volatile uint32_t i = 0; i < 4800000; i++);  // ~2 seconds pause
+        Timebase_DelayMs(2000);
         
-        // === Turn Right using PIT timer ===
-        UART_SendString("Turn Right... (PIT timer)\r\n");
+        // === Turn Right (timebase) ===
+        UART_SendString("Turn Right... (timebase)\r\n");
         Motor_TurnRight(100);
-        TestTurnTimer_Start();
         WaitForTurnComplete();
         
         UART_SendString("Stop - Cycle Complete\r\n\r\n");
         Motor_Stop();
-        for (volatile uint32_t i = 0; i < 24000000; i++);
+        Timebase_DelayMs(10000);
     }
 }
 
@@ -306,34 +280,27 @@ void run_test_ultrasonic(void)
     Ultrasonic_Init();
     
     while (1) {
-        // Read FRONT sensor
-        uint32_t frontDistance = Ultrasonic_GetDistanceCm();
-        
-        UART_SendString("FRONT: ");
-        UART_SendNumber(frontDistance);
-        UART_SendString(" cm");
-        if (frontDistance < OBSTACLE_THRESHOLD_CM) {
-            UART_SendString(" OBSTACLE!");
-        }
-        
-        UART_SendString("  |  ");
+        // One trigger, both echoes
+        UltrasonicReading_t reading;
         
-        // Small delay between sensor readings to avoid interference
-        for (volatile uint32_t i = 0; i < 100000; i++);
+        Ultrasonic_Measure(&reading);
         
-        // Read REAR sensor
-        uint32_t rearDistance = Ultrasonic_GetRearDistanceCm();
-        
-        UART_SendString("REAR: ");
-        UART_SendNumber(rearDistance);
-        UART_SendString(" cm");
-        if (rearDistance < OBSTACLE_THRESHOLD_CM) {
-            UART_SendString(" OBSTACLE!");
+        for (uint32_t i = 0; i < ULTRASONIC_SENSOR_COUNT; i++) {
+            const UltrasonicEcho_t *echo = &reading.echo[i];
+            
+            UART_SendString((i == ULTRASONIC_FRONT) ? "FRONT: " : "  |  REAR: ");
+            UART_SendNumber(echo->distanceCm);
+            UART_SendString(" cm");
+            if (echo->status == ULTRASONIC_CROSSTALK) {
+                UART_SendString(" (crosstalk)");
+            } else if (echo->distanceCm < OBSTACLE_THRESHOLD_CM) {
+                UART_SendString(" OBSTACLE!");
+            }
         }
         UART_SendString("\r\n");
         
-        // Wait ~500ms between readings
-        for (volatile uint32_t i = 0; i < 1200000; i++);
+        // Wait 500ms between readings
+        Timebase_DelayMs(500);
     }
 }
 
@@ -344,14 +311,13 @@ void run_test_ultrasonic(void)
  */
 CarEvent_t ConvertBluetoothToEvent(BluetoothCommand cmd)
 {
-    switch (cmd) {
-        case CMD_FORWARD:   return EVENT_CMD_FORWARD;
-        case CMD_BACKWARD:  return EVENT_CMD_BACKWARD;
-        case CMD_LEFT:      return EVENT_CMD_LEFT;
-        case CMD_RIGHT:     return EVENT_CMD_RIGHT;
-        case CMD_STOP:      return EVENT_CMD_STOP;
-        default:            return EVENT_NONE;
-    }
+#define COMMAND_EVENT_ENTRY(id, first, last, alt, event, help)  [(id)] = (event),
+    static const uint8_t commandEvent[CMD_UNKNOWN + 1] = {
+        BLUETOOTH_COMMAND_LIST(COMMAND_EVENT_ENTRY)
+    };
+#undef COMMAND_EVENT_ENTRY
+
+    return (cmd <= CMD_UNKNOWN) ? (CarEvent_t)commandEvent[cmd] : EVENT_NONE;
 }
 
 /**
@@ -362,20 +328,20 @@ void ProcessNonMovementCommand(BluetoothCommand cmd, uint8_t speed)
 {
     switch (cmd) {
         case CMD_LIGHTS_ON:
-            Bluetooth_SendString(">> Lights ON\r\n");
+            Msg_Send(MSG_LIGHTS_ON);
             autoLightsMode = 0;
             Lights_On();
             break;
             
         case CMD_LIGHTS_OFF:
-            Bluetooth_SendString(">> Lights OFF\r\n");
+            Msg_Send(MSG_LIGHTS_OFF);
             autoLightsMode = 0;
             Lights_Off();
             break;
             
         case CMD_LIGHTS_AUTO:
             autoLightsMode = !autoLightsMode;
-            Bluetooth_SendString(autoLightsMode ? ">> Auto-lights ON\r\n" : ">> Auto-lights OFF\r\n");
+            Msg_Send(autoLightsMode ? MSG_AUTO_LIGHTS_ON : MSG_AUTO_LIGHTS_OFF);
             break;
             
         case CMD_GET_TEMP:
@@ -387,13 +353,20 @@ void ProcessNonMovementCommand(BluetoothCommand cmd, uint8_t speed)
             
         case CMD_SET_SPEED:
             FSM_SetSpeed(speed);
-            Bluetooth_SendString("Speed: ");
-            Bluetooth_SendNumber(speed);
-            Bluetooth_SendString("%\r\n");
+            Msg_Send(MSG_SPEED, (uint32_t)speed);
+            break;
+            
+        case CMD_MSG_MODE:
+            Msg_SetMode((Msg_GetMode() == MSG_MODE_VERBOSE) ? MSG_MODE_COMPACT : MSG_MODE_VERBOSE);
+            Msg_Send((Msg_GetMode() == MSG_MODE_VERBOSE) ? MSG_VERBOSE_ON : MSG_COMPACT_ON);
+            break;
+            
+        case CMD_PROF_DUMP:
+            Prof_Dump();
             break;
             
         case CMD_UNKNOWN:
-            Bluetooth_SendString("? Unknown command\r\n");
+            Msg_Send(MSG_UNKNOWN_COMMAND);
             break;
             
         default:
@@ -406,60 +379,207 @@ void ProcessNonMovementCommand(BluetoothCommand cmd, uint8_t speed)
  */
 void SendSensorInfo(void)
 {
-    uint16_t temperature, humidity;
-    
-    Bluetooth_SendString("=== Sensor Info ===\r\n");
+    Msg_Send(MSG_INFO_HEADER);
     
     // Current FSM state
-    Bluetooth_SendString("State: ");
-    Bluetooth_SendString(FSM_GetStateName(FSM_GetState()));
-    Bluetooth_SendString("\r\n");
-    
-    // Distance FRONT
-    uint32_t frontDistance = Ultrasonic_GetDistanceCm();
-    Bluetooth_SendString("FRONT: ");
-    Bluetooth_SendNumber(frontDistance);
-    Bluetooth_SendString(" cm\r\n");
-    
-    // Distance REAR
-    uint32_t rearDistance = Ultrasonic_GetRearDistanceCm();
-    Bluetooth_SendString("REAR: ");
-    Bluetooth_SendNumber(rearDistance);
-    Bluetooth_SendString(" cm\r\n");
+    Msg_Send(MSG_INFO_STATE, FSM_GetStateName(FSM_GetState()));
+    
+    // Distance FRONT / REAR
+    DistanceSnapshot_t distance;
+    Ultrasonic_GetSnapshot(&distance);  // Background ranging, no ping here
+    Msg_Send(MSG_INFO_DISTANCE, distance.frontCm, distance.rearCm);
     
     // LDR
     uint16_t ldr = Ldr_Read();
-    Bluetooth_SendString("Light: ");
-    Bluetooth_SendNumber(ldr);
-    Bluetooth_SendString(" (ADC)\r\n");
+    Msg_Send(MSG_INFO_LIGHT, (uint32_t)ldr);
     
-    // DHT11 - read directly (user manually triggers via 'I' command)
-    DHT11_ErrorCode result = DHT11_Read(&temperature, &humidity);
+    // DHT11 - last periodic reading (Task_Climate), no blocking read here
+    if (climateStatus == DHT11_OK) {
+        Msg_Send(MSG_INFO_CLIMATE, (uint32_t)climateTemperature, Fmt_Div100(climateHumidity));
+    } else {
+        Msg_Send(MSG_INFO_DHT11_ERROR, DHT11_GetErrorString(climateStatus));
+    }
     
-    if (result == DHT11_OK) {
-        Bluetooth_SendString("Temp: ");
-        Bluetooth_SendNumber(temperature / 100);
-        Bluetooth_SendString(".");
-        Bluetooth_SendNumber(temperature % 100);
-        Bluetooth_SendString(" C\r\n");
+    // STOP fast path (UART ISR)
+    BluetoothRxStats_t rxStats;
+    Bluetooth_GetRxStats(&rxStats);
+    Msg_Send(MSG_INFO_ESTOP, rxStats.emergencyStops, rxStats.stopLatencyMaxUs);
+    
+    // Event queues: deepest backlog and events lost (all sources)
+    EventStats_t eventStats;
+    uint32_t maxQueued = 0, lost = 0;
+    Events_GetStats(&eventStats);
+    for (uint32_t i = 0; i < EVENT_SRC_COUNT; i++) {
+        if (eventStats.highWater[i] > maxQueued) maxQueued = eventStats.highWater[i];
+        lost += eventStats.overflows[i];
+    }
+    Msg_Send(MSG_INFO_EVENTS, maxQueued, lost);
+    
+    // Scheduler: per-task timing
+    for (uint8_t i = 0; i < Scheduler_GetTaskCount(); i++) {
+        TaskStats_t task;
+        Scheduler_GetTaskStats(i, &task);
+        Msg_Send(MSG_INFO_TASK, task.name, task.runs, task.overruns, task.maxRunMs);
+    }
+    
+    // Low-power idle residency (tools/power_estimate turns it into mA)
+    PowerStats_t power;
+    Power_GetStats(&power);
+    Msg_Send(MSG_INFO_POWER, power.runMs, power.waitMs, power.vlpsMs);
+    
+    // Command byte -> PWM write (bucket bounds; 'Z' for the full histogram)
+    ProfSummary_t latency;
+    Prof_GetSummary(PROF_CMD_LATENCY, &latency);
+    Msg_Send(MSG_INFO_CMD_LATENCY, latency.p50Us, latency.p99Us, latency.maxUs);
+    
+    Msg_Send(MSG_INFO_FOOTER);
+}
+
+/**
+ * @brief No movement command for COMMAND_TIMEOUT_MS (software timer, TPM2 ISR)
+ */
+static void CommandTimeout_Expired(void *arg)
+{
+    (void)arg;
+    Events_Post(EVENT_SRC_TIMER, EVENT_CMD_STOP, 0);  // Ignored if already IDLE
+}
+
+/**
+ * @brief Task: drain received commands and queued FSM events (every pass)
+ */
+static void Task_Commands(void)
+{
+    BluetoothCommand cmd;
+    
+    while ((cmd = Bluetooth_GetCommand()) != CMD_NONE) {
+        // Try to convert to FSM event (movement commands)
+        CarEvent_t event = ConvertBluetoothToEvent(cmd);
         
-        Bluetooth_SendString("Humidity: ");
-        Bluetooth_SendNumber(humidity / 100);
-        Bluetooth_SendString("%\r\n");
+        if (event != EVENT_NONE) {
+            Events_PostAt(EVENT_SRC_MAIN, event, 0, Bluetooth_GetCommandTimeUs());
+            
+            if (COMMAND_TIMEOUT_MS != 0 && event != EVENT_CMD_STOP) {
+                SwTimer_Start(&commandTimeout, COMMAND_TIMEOUT_MS, 0);
+            } else {
+                SwTimer_Stop(&commandTimeout);
+            }
+            
+            if (cmd == CMD_STOP && Bluetooth_TakeIsrStop()) {
+                // The UART ISR already cut the motors. Let the FSM take every
+                // command queued before this STOP while the PWM is still
+                // locked, so none of them restarts the car, then unlock
+                FSM_Update();
+                Motor_ReleaseEmergencyStop();
+            }
+        } else {
+            // If not a movement command, process separately
+            // (a speed change rewrites the PWM right here)
+            Motor_TraceCommand(Bluetooth_GetCommandTimeUs());
+            ProcessNonMovementCommand(cmd, Bluetooth_GetSpeed());
+            Motor_TraceEnd();
+        }
+    }
+    
+    // Drain queued events (commands, obstacles, turn completion,
+    // UART STOP fast path) in order
+    FSM_Update();
+}
+
+/**
+ * @brief Task: obstacle detection (FRONT when FORWARD, REAR when BACKWARD)
+ *
+ * Checks each new background ranging snapshot once and stops on time to
+ * collision: closing speed from consecutive distances against the braking
+ * distance at the current speed (ttc.h).
+ */
+static void Task_Obstacle(void)
+{
+    static uint32_t lastSequence = 0;
+    static TtcTracker_t tracker;
+    static CarState_t lastState = STATE_IDLE;
+    CarState_t state = FSM_GetState();
+    DistanceSnapshot_t snap;
+    UltrasonicSensor_t sensor;
+    
+    Ultrasonic_GetSnapshot(&snap);
+    if (snap.sequence == lastSequence) {
+        return;
+    }
+    lastSequence = snap.sequence;
+    
+    // New direction (or sensor): the previous distances are another target
+    if (state != lastState) {
+        Ttc_Reset(&tracker);
+        lastState = state;
+    }
+    
+    if (state == STATE_FORWARD) {
+        sensor = ULTRASONIC_FRONT;
+    } else if (state == STATE_BACKWARD) {
+        sensor = ULTRASONIC_REAR;
     } else {
-        Bluetooth_SendString("DHT11: Error - ");
-        Bluetooth_SendString(DHT11_GetErrorString(result));
-        Bluetooth_SendString("\r\n");
+        return;
+    }
+    
+    uint32_t distance = (sensor == ULTRASONIC_FRONT) ? snap.frontCm : snap.rearCm;
+    uint8_t confidence = (sensor == ULTRASONIC_FRONT) ? snap.frontConfidence : snap.rearConfidence;
+    
+    // Ranging stalled (e.g. ECHO stuck high): do not act on an old distance
+    if (!(snap.valid & ULTRASONIC_VALID(sensor)) || confidence < OBSTACLE_MIN_CONFIDENCE ||
+        Timebase_ElapsedUs(snap.timeUs) >= OBSTACLE_MAX_AGE_US) {
+        Ttc_Reset(&tracker);
+        return;
     }
     
-    Bluetooth_SendString("==================\r\n");
+    if (Ttc_Update(&tracker, distance, snap.timeUs, Timebase_GetUs(), FSM_GetSpeed())) {
+        // Queued behind any command already posted
+        Events_Post(EVENT_SRC_MAIN, EVENT_OBSTACLE, (uint16_t)distance);
+        if (sensor == ULTRASONIC_FRONT) {
+            FSM_SendObstacleAlert(distance);
+        } else {
+            Msg_Send(MSG_OBSTACLE_REAR, distance);
+        }
+        // Stop now rather than on the next pass
+        FSM_Update();
+    }
+}
+
+/**
+ * @brief Task: auto lights (LDR polling - separate from FSM)
+ */
+static void Task_AutoLights(void)
+{
+    if (autoLightsMode) {
+        uint16_t ldr_value = Ldr_Read();
+        Lights_Auto(ldr_value);
+    }
+}
+
+/**
+ * @brief Task: refresh the cached DHT11 reading
+ */
+static void Task_Climate(void)
+{
+    uint16_t temperature, humidity;
+    DHT11_ErrorCode result = DHT11_Read(&temperature, &humidity);
+    
+    climateStatus = result;
+    if (result == DHT11_OK) {
+        climateTemperature = temperature;
+        climateHumidity = humidity;
+    }
 }
 
 /**
  * @brief Main application loop using FSM architecture
  * 
  * FSM handles: IDLE, FORWARD, BACKWARD, LEFT, RIGHT states
- * Separate polling: LDR-based auto-lights (independent of car movement)
+ * Everything else runs as scheduler tasks (SysTick time base):
+ *   commands  - every pass, priority 0
+ *   obstacle  - 20Hz, priority 1
+ *   lights    - 5Hz, priority 2 (independent of car movement)
+ *   climate   - 0.5Hz, priority 3 (DHT11, cached for the 'I' command)
+ * Between releases the MCU sleeps (power.c).
  */
 void run_main_application(void)
 {
@@ -469,85 +589,34 @@ void run_main_application(void)
     UART_SendString("       (FSM Architecture)       \r\n");
     UART_SendString("================================\r\n");
     UART_SendString("Commands:\r\n");
-    UART_SendString("  F/W=Forward B/X=Back L/A=Left R/D=Right S=Stop\r\n");
-    UART_SendString("  O=LightsON P=LightsOFF M=AutoMode\r\n");
-    UART_SendString("  T=Temp H=Humidity U=Distance I=Info\r\n");
-    UART_SendString("  1-9=Set Speed (10%-90%)\r\n");
+    UART_SendString(BLUETOOTH_HELP_TEXT);
     UART_SendString("================================\r\n\r\n");
 
     // Initialize all modules
+    SwTimer_Init();
+    SwTimer_Setup(&commandTimeout, CommandTimeout_Expired, NULL);
     Ldr_Init();
     Lights_Init();
     DHT11_Init(); 
     Motor_Init();
     Ultrasonic_Init();
+    Ultrasonic_StartRanging();
     Bluetooth_Init();
     
     // Initialize FSM (starts in IDLE state)
     FSM_Init();
+    Power_Init();
     
     UART_SendString("System Ready!\r\n");
     
-    while (1)
-    {
-        CarEvent_t event = EVENT_NONE;
-        
-        // =========================================
-        // 1. Read and convert Bluetooth command to FSM event
-        // =========================================
-        BluetoothCommand cmd = Bluetooth_GetCommand();
-        if (cmd != CMD_NONE) {
-            // Try to convert to FSM event (movement commands)
-            event = ConvertBluetoothToEvent(cmd);
-            
-            // If not a movement command, process separately
-            if (event == EVENT_NONE) {
-                ProcessNonMovementCommand(cmd, Bluetooth_GetSpeed());
-            }
-        }
-        
-        // =========================================
-        // 2. Obstacle Detection (FRONT when FORWARD, REAR when BACKWARD)
-        // =========================================
-        if (FSM_GetState() == STATE_FORWARD) {
-            uint32_t distance = Ultrasonic_GetDistanceCm();
-            
-            if (distance < OBSTACLE_THRESHOLD_CM && distance > 0 && distance < 500) {
-                // Front obstacle detected! Override any pending event
-                event = EVENT_OBSTACLE;
-                FSM_SendObstacleAlert(distance);
-            }
-        }
-        else if (FSM_GetState() == STATE_BACKWARD) {
-            uint32_t rearDistance = Ultrasonic_GetRearDistanceCm();
-            
-            if (rearDistance < OBSTACLE_THRESHOLD_CM && rearDistance > 0 && rearDistance < 500) {
-                // Rear obstacle detected! Override any pending event
-                event = EVENT_OBSTACLE;
-                Bluetooth_SendString("!! REAR OBSTACLE at ");
-                Bluetooth_SendNumber(rearDistance);
-                Bluetooth_SendString(" cm - STOPPED !!\r\n");
-            }
-        }
-        
-        // =========================================
-        // 3. Process event through FSM
-        // =========================================
-        if (event != EVENT_NONE) {
-            FSM_ProcessEvent(event);
-        }
-        
-        // =========================================
-        // 4. Update FSM (check for turn completion)
-        // =========================================
-        FSM_Update();
-        
-        // =========================================
-        // 5. Auto Lights (LDR polling - separate from FSM)
-        // =========================================
-        if (autoLightsMode) {
-            uint16_t ldr_value = Ldr_Read();
-            Lights_Auto(ldr_value);
-        }
-    }
+    // From now on never stall the control loop on a full TX buffer
+    UART_SetTxPolicy(UART_TX_DROP);
+    
+    Scheduler_AddTask("commands", Task_Commands, 0, COMMANDS_DEADLINE_MS, 0);
+    Scheduler_AddTask("obstacle", Task_Obstacle, OBSTACLE_PERIOD_MS, OBSTACLE_DEADLINE_MS, 1);
+    Scheduler_AddTask("lights", Task_AutoLights, LIGHTS_PERIOD_MS, LIGHTS_DEADLINE_MS, 2);
+    Scheduler_AddTask("climate", Task_Climate, CLIMATE_PERIOD_MS, CLIMATE_DEADLINE_MS, 3);
+    Scheduler_SetIdleHook(Power_Idle);
+    
+    Scheduler_Run();
 }
@@ -1,66 +1,369 @@
 #include "bluetooth.h"
 #include "uart.h"
 #include "motor.h"
+#include "proto.h"
+#include "events.h"
+#include "timebase.h"
+#include "prof.h"
 #include "MKL25Z4.h"
+#include "fsl_dma.h"
+#include "fsl_dmamux.h"
 
 /**
- * Bluetooth Command Parser with UART0 RX Interrupt
+ * Bluetooth Command Parser with UART0 RX
  * 
- * Uses UART0 RX interrupt to buffer incoming bytes.
- * Commands are stored in a ring buffer and processed by main loop.
+ * Incoming bytes land in a ring buffer and are processed by main loop.
  * This prevents losing commands during sensor reads.
+ * 
+ * BLUETOOTH_RX_USE_DMA = 1 (default): DMA channel 1 writes every byte into
+ *   a circular buffer (DMA destination modulo). The UART idle-line
+ *   interrupt marks the end of a burst and publishes the new write index,
+ *   so the ISR runs once per burst instead of once per byte.
+ * 
+ * BLUETOOTH_RX_USE_DMA = 0: RDRF interrupt per byte.
+ * 
+ * Commands arrive either as single ASCII characters or as binary frames
+ * (proto.h). Frames are decoded byte by byte straight out of the ring
+ * buffer, so no frame buffer is needed.
+ * 
+ * STOP fast path: the UART0 ISR scans every burst for an ASCII STOP and
+ * cuts the motors right there (Motor_EmergencyStop), without waiting for
+ * the main loop. Worst case from the end of the STOP byte to the direction
+ * pins going low:
+ *   (bytes after it in the burst + 1 idle character) x 1.04ms
+ *   + longest interrupts-off window (DHT11 data phase, ~5ms)
+ *   + ISR time (a few us)
+ * For a lone 'S' that is ~1.1ms, or ~6ms if it lands during a DHT11 read.
+ * The measured part (burst + ISR) is kept in stopLatencyMaxUs.
+ * 
+ * Overflow (unread bytes overwritten / dropped) and line errors are
+ * counted instead of silently discarded - see Bluetooth_GetRxStats().
+ * 
+ * Latency tracing: the ISR stamps every byte with its arrival time
+ * (rxStampUs, parallel to rxBuffer). A command carries the stamp of the
+ * byte that completed it (the ASCII key, or a frame's closing delimiter)
+ * through coalescing, and Task_Commands posts its event with that stamp,
+ * so the motor PWM update can measure byte -> PWM write (PROF_CMD_LATENCY).
  */
+#define BLUETOOTH_RX_USE_DMA    1
+
+// DMA channel used for UART0 RX
+#define RX_DMA_CHANNEL          1U
+
+// Byte count programmed into the DMA channel; re-armed from the idle ISR
+#define RX_DMA_BCR_START        0xFFFFFU
+#define RX_DMA_BCR_REARM        0x10000U
+
+// Ring buffer for received bytes (power of two, aligned for DMA modulo)
+#define RX_BUFFER_SIZE  64U
+#define RX_BUFFER_MASK  (RX_BUFFER_SIZE - 1U)
+static volatile uint8_t rxBuffer[RX_BUFFER_SIZE] __attribute__((aligned(RX_BUFFER_SIZE)));
+static volatile uint32_t rxHead = 0;  // Free-running write count (ISR publishes)
+static volatile uint32_t rxTail = 0;  // Free-running read count (main loop)
+static volatile uint32_t rxStampUs[RX_BUFFER_SIZE];  // Arrival time of each byte
+static uint32_t rxLastStampUs = 0;    // Stamp of the byte Bluetooth_GetByte() returned last
+
+#if BLUETOOTH_RX_USE_DMA
+static uint32_t rxDmaBase = 0;        // Bytes received before the last DMA re-arm
+#endif
+
+static volatile BluetoothRxStats_t rxStats;
+
+// One character on the wire at 9600 baud 8N1 (10 bits), in microseconds
+#define UART_CHAR_TIME_US       1042U
 
-// Ring buffer for received bytes
-#define RX_BUFFER_SIZE  32
-static volatile uint8_t rxBuffer[RX_BUFFER_SIZE];
-static volatile uint8_t rxHead = 0;  // Write index (ISR writes here)
-static volatile uint8_t rxTail = 0;  // Read index (main loop reads here)
+// Binary frame tracking for the STOP fast path (mirrors proto.c framing,
+// including its way out of a frame that never closes)
+static bool isrInFrame = false;
+static uint8_t isrFrameLen = 0;       // Bytes since the opening delimiter
+static uint32_t isrLastByteUs = 0;    // Arrival of the previous byte
+
+// Last STOP byte the ISR latched on: rxTail once the reader is past it.
+// Cleared when Bluetooth_GetCommand() hands that STOP out (read, or
+// replayed if the byte was lost to an overflow).
+static volatile uint32_t isrStopEnd = 0;
+static volatile bool isrStopPending = false;
+static bool isrStopTaken = false;     // Handed out, see Bluetooth_TakeIsrStop()
 
 static uint8_t currentSpeed = 0;  // Will be set from Motor_GetDefaultSpeed()
 
+// Longest movement/speed run collapsed in one Bluetooth_GetCommand call
+#define COALESCE_MAX_RUN        32U
+
+// Commands produced by one coalescing pass: [STOP] [SET_SPEED] [move] [other]
+static BluetoothCommand outQueue[4];
+static uint32_t outStampUs[4];
+static uint8_t outCount = 0;
+static uint8_t outRead = 0;
+
+static uint32_t frameStampUs = 0;     // Closing delimiter of the last binary frame
+static uint32_t readStampUs = 0;      // Stamp of the last Bluetooth_ReadCommand() result
+static uint32_t commandStampUs = 0;   // Stamp of the last Bluetooth_GetCommand() result
+
+/**
+ * @brief Count and clear UART0 line errors (flags are write-1-to-clear)
+ */
+static void Bluetooth_HandleLineErrors(uint8_t s1)
+{
+    uint8_t errors = s1 & (UART0_S1_OR_MASK | UART0_S1_NF_MASK | UART0_S1_FE_MASK | UART0_S1_PF_MASK);
+    
+    if (errors == 0) {
+        return;
+    }
+    if (errors & UART0_S1_OR_MASK) rxStats.hwOverruns++;
+    if (errors & UART0_S1_NF_MASK) rxStats.noiseErrors++;
+    if (errors & UART0_S1_FE_MASK) rxStats.framingErrors++;
+    if (errors & UART0_S1_PF_MASK) rxStats.parityErrors++;
+    
+    UART0->S1 = errors;
+}
+
+/**
+ * @brief Raw byte -> command lookup (flash), generated from bluetooth_commands.h
+ * Control characters (0-31) map to CMD_NONE, any other unlisted byte to
+ * CMD_UNKNOWN. Entries for keys without a lowercase form or alternative
+ * repeat the same value, hence the override-init pragma.
+ */
+#define BLUETOOTH_TABLE_ENTRY(id, first, last, alt, event, help)              \
+    [(first) ... (last)] = (id),                                             \
+    [BLUETOOTH_KEY_LOWER(first) ... BLUETOOTH_KEY_LOWER(last)] = (id),       \
+    [(alt)] = (id),                                                          \
+    [BLUETOOTH_KEY_LOWER(alt)] = (id),
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Woverride-init"
+static const uint8_t asciiCommand[256] = {
+    [0x20 ... 0xFF] = CMD_UNKNOWN,
+    BLUETOOTH_COMMAND_LIST(BLUETOOTH_TABLE_ENTRY)
+};
+#pragma GCC diagnostic pop
+
+#undef BLUETOOTH_TABLE_ENTRY
+
+/**
+ * @brief STOP fast path: cut the motors as soon as an ASCII STOP is seen
+ * 
+ * Runs in the UART0 ISR. The FSM is told through the event queue; the
+ * byte itself stays in the RX buffer and releases the motor lock once
+ * Bluetooth_GetCommand() reaches it, so older commands still queued in
+ * the buffer cannot restart the car. If the byte is overwritten (or
+ * dropped) before it is read, Bluetooth_GetCommand() returns a STOP in
+ * its place, so the lock never outlives a lost byte. Bytes inside binary
+ * frames are skipped. A frame ends where proto.c gives up on it too -
+ * after PROTO_FRAME_GAP_US of silence or PROTO_MAX_ENCODED_LEN bytes -
+ * so a frame the link cut off never turns the fast path off.
+ * 
+ * @param byte      Received byte
+ * @param end       rxTail once the reader is past this byte
+ * @param after     Bytes received after this one in the same burst
+ * @param byteUs    Arrival time of the byte (its rxStampUs)
+ * @param entryUs   Timebase_GetUs() at ISR entry
+ */
+static void Bluetooth_CheckEmergencyStop(uint8_t byte, uint32_t end, uint32_t after, uint32_t byteUs,
+                                         uint32_t entryUs)
+{
+    if (isrInFrame && byteUs - isrLastByteUs > PROTO_FRAME_GAP_US) {
+        isrInFrame = false;  // Proto_Timeout()
+    }
+    isrLastByteUs = byteUs;
+    
+    if (byte == PROTO_DELIMITER) {
+        isrInFrame = !(isrInFrame && isrFrameLen > 0);
+        isrFrameLen = 0;
+        return;
+    }
+    if (isrInFrame) {
+        if (++isrFrameLen > PROTO_MAX_ENCODED_LEN) {
+            isrInFrame = false;  // Longer than any frame: ASCII again
+        }
+        return;
+    }
+    if (asciiCommand[byte] != CMD_STOP) {
+        return;
+    }
+    
+    Motor_EmergencyStop();
+    Events_Post(EVENT_SRC_UART, EVENT_CMD_STOP, 0);  // FSM follows to IDLE
+    isrStopEnd = end;
+    isrStopPending = true;
+    
+    // Latency from the end of the STOP byte: the rest of the burst, one
+    // idle character, then this ISR up to the pin write
+    uint32_t latencyUs = (after + 1U) * UART_CHAR_TIME_US + Timebase_ElapsedUs(entryUs);
+    
+    rxStats.emergencyStops++;
+    if (latencyUs > rxStats.stopLatencyMaxUs) {
+        rxStats.stopLatencyMaxUs = latencyUs;
+    }
+}
+
+#if BLUETOOTH_RX_USE_DMA
+
+/**
+ * @brief Total number of bytes the DMA has written so far
+ */
+static inline uint32_t Bluetooth_DmaWritten(void)
+{
+    return rxDmaBase + (RX_DMA_BCR_START - DMA_GetRemainingBytes(DMA0, RX_DMA_CHANNEL));
+}
+
+/**
+ * @brief Start circular RX DMA: UART0->D -> rxBuffer, wrapping every RX_BUFFER_SIZE
+ */
+static void Bluetooth_InitRxDma(void)
+{
+    dma_transfer_config_t config;
+    
+    DMAMUX_Init(DMAMUX0);
+    DMAMUX_SetSource(DMAMUX0, RX_DMA_CHANNEL, kDmaRequestMux0UART0Rx);
+    DMAMUX_EnableChannel(DMAMUX0, RX_DMA_CHANNEL);
+    
+    DMA_Init(DMA0);
+    DMA_ResetChannel(DMA0, RX_DMA_CHANNEL);
+    DMA_PrepareTransfer(&config, (void *)&UART0->D, sizeof(uint8_t), (void *)rxBuffer, sizeof(uint8_t),
+                        RX_DMA_BCR_START, kDMA_PeripheralToMemory);
+    DMA_SetTransferConfig(DMA0, RX_DMA_CHANNEL, &config);
+    DMA_SetModulo(DMA0, RX_DMA_CHANNEL, kDMA_ModuloDisable, kDMA_Modulo64Bytes);
+    DMA_EnableChannelRequest(DMA0, RX_DMA_CHANNEL);
+    
+    // RDRF -> DMA request, idle line and line errors -> interrupt
+    UART0->C1 |= UART0_C1_ILT_MASK;  // Idle count starts after the stop bit
+    UART0->C3 |= UART0_C3_ORIE_MASK | UART0_C3_NEIE_MASK | UART0_C3_FEIE_MASK | UART0_C3_PEIE_MASK;
+    UART0->C5 |= UART0_C5_RDMAE_MASK;
+    UART0->C2 |= UART0_C2_RIE_MASK | UART0_C2_ILIE_MASK;
+}
+
+/**
+ * @brief Refill the DMA byte count before it runs out
+ * @note Only called at idle line, so no byte is in flight
+ */
+static void Bluetooth_RearmRxDma(void)
+{
+    if (DMA_GetRemainingBytes(DMA0, RX_DMA_CHANNEL) > RX_DMA_BCR_REARM) {
+        return;
+    }
+    
+    DMA_DisableChannelRequest(DMA0, RX_DMA_CHANNEL);
+    rxDmaBase = Bluetooth_DmaWritten();
+    DMA_ClearChannelStatusFlags(DMA0, RX_DMA_CHANNEL, kDMA_TransactionsDoneFlag);
+    DMA_SetTransferSize(DMA0, RX_DMA_CHANNEL, RX_DMA_BCR_START);
+    DMA_EnableChannelRequest(DMA0, RX_DMA_CHANNEL);
+}
+
+/**
+ * @brief UART0 Interrupt Handler
+ * Idle line = end of a received burst: publish everything the DMA wrote.
+ * Also services line errors and the TX side.
+ */
+void UART0_IRQHandler(void)
+{
+    uint32_t entryUs = Timebase_GetUs();
+    uint8_t s1 = UART0->S1;
+    
+    Bluetooth_HandleLineErrors(s1);
+    
+    if ((s1 & UART0_S1_IDLE_MASK) && (UART0->C2 & UART0_C2_ILIE_MASK)) {
+        UART0->S1 = UART0_S1_IDLE_MASK;  // Write 1 to clear
+        
+        uint32_t head = Bluetooth_DmaWritten();
+        uint32_t from = rxHead;
+        
+        // Stamp the new burst and scan it for STOP (only the last
+        // RX_BUFFER_SIZE bytes still exist). Byte i finished one idle
+        // character plus the bytes after it before this ISR.
+        if (head - from > RX_BUFFER_SIZE) {
+            from = head - RX_BUFFER_SIZE;
+        }
+        for (uint32_t i = from; i != head; i++) {
+            uint32_t byteUs = entryUs - (head - i) * UART_CHAR_TIME_US;
+            rxStampUs[i & RX_BUFFER_MASK] = byteUs;
+            Bluetooth_CheckEmergencyStop(rxBuffer[i & RX_BUFFER_MASK], i + 1U, head - i - 1U, byteUs, entryUs);
+        }
+        
+        rxHead = head;
+        rxStats.bursts++;
+        
+        Bluetooth_RearmRxDma();
+    }
+    
+    // Feed the next queued TX byte (uart.c)
+    UART_TxIRQHandler();
+    
+    PROF_END(PROF_ISR_UART0, entryUs);
+}
+
+#else
+
 /**
  * @brief UART0 Interrupt Handler
  * Called automatically when a byte is received on UART0
+ * or when the TX data register is empty (TX ring buffer drain)
  */
 void UART0_IRQHandler(void)
 {
+    uint32_t entryUs = Timebase_GetUs();
+    uint8_t s1 = UART0->S1;
+    
     // Check if RX data register is full
-    if (UART0->S1 & UART_S1_RDRF_MASK) {
+    if (s1 & UART_S1_RDRF_MASK) {
         uint8_t byte = UART0->D;  // Read byte (also clears RDRF flag)
+        bool stored = (rxHead - rxTail < RX_BUFFER_SIZE);
         
-        // Calculate next head position
-        uint8_t nextHead = (rxHead + 1) % RX_BUFFER_SIZE;
+        // A dropped STOP is passed once everything before it is read
+        Bluetooth_CheckEmergencyStop(byte, rxHead + (stored ? 1U : 0U), 0, entryUs, entryUs);
         
         // Only store if buffer not full
-        if (nextHead != rxTail) {
-            rxBuffer[rxHead] = byte;
-            rxHead = nextHead;
+        if (stored) {
+            rxBuffer[rxHead & RX_BUFFER_MASK] = byte;
+            rxStampUs[rxHead & RX_BUFFER_MASK] = entryUs;
+            rxHead++;
+        } else {
+            rxStats.overflows++;  // Buffer full, byte dropped
         }
-        // If buffer is full, byte is dropped (overflow)
+        rxStats.bursts++;
     }
     
-    // Clear any error flags
-    if (UART0->S1 & (UART_S1_OR_MASK | UART_S1_NF_MASK | UART_S1_FE_MASK | UART_S1_PF_MASK)) {
-        (void)UART0->D;  // Read to clear errors
-    }
+    Bluetooth_HandleLineErrors(s1);
+    
+    // Feed the next queued TX byte (uart.c)
+    UART_TxIRQHandler();
+    
+    PROF_END(PROF_ISR_UART0, entryUs);
 }
 
+#endif /* BLUETOOTH_RX_USE_DMA */
+
 void Bluetooth_Init(void)
 {
     // Reset buffer indices
     rxHead = 0;
     rxTail = 0;
     currentSpeed = Motor_GetDefaultSpeed();  // Get default from motor.c
+    outCount = 0;
+    outRead = 0;
+    Proto_Reset();
+    isrInFrame = false;
+    isrFrameLen = 0;
+    isrStopPending = false;
+    isrStopTaken = false;
     
+#if BLUETOOTH_RX_USE_DMA
+    rxDmaBase = 0;
+    Bluetooth_InitRxDma();
+#else
     // Enable UART0 RX interrupt
     UART0->C2 |= UART_C2_RIE_MASK;  // Enable RX interrupt
+#endif
     
     // Enable UART0 interrupt in NVIC
-    NVIC_SetPriority(UART0_IRQn, 2);  // Priority 2 (medium)
+    NVIC_SetPriority(UART0_IRQn, 0);  // Highest: the STOP fast path runs here
     NVIC_EnableIRQ(UART0_IRQn);
 
+#if BLUETOOTH_RX_USE_DMA
+    UART_SendString("  Bluetooth init (RX circular DMA + idle line)\r\n");
+#else
     UART_SendString("  Bluetooth init (RX interrupt enabled)\r\n");
+#endif
 }
 
 /**
@@ -71,6 +374,21 @@ bool Bluetooth_Available(void)
     return (rxHead != rxTail);
 }
 
+/**
+ * @brief Skip bytes the DMA has already overwritten (more than one buffer
+ *        of unread data), counting them as overflows
+ */
+static void Bluetooth_DropOverwritten(void)
+{
+#if BLUETOOTH_RX_USE_DMA
+    uint32_t head = rxHead;
+    if (head - rxTail > RX_BUFFER_SIZE) {
+        rxStats.overflows += head - rxTail - RX_BUFFER_SIZE;
+        rxTail = head - RX_BUFFER_SIZE;
+    }
+#endif
+}
+
 /**
  * @brief Get a byte from the ring buffer
  * @return Received byte, or 0 if buffer empty
@@ -81,8 +399,11 @@ uint8_t Bluetooth_GetByte(void)
         return 0;
     }
     
-    uint8_t byte = rxBuffer[rxTail];
-    rxTail = (rxTail + 1) % RX_BUFFER_SIZE;
+    Bluetooth_DropOverwritten();
+    
+    uint8_t byte = rxBuffer[rxTail & RX_BUFFER_MASK];
+    rxLastStampUs = rxStampUs[rxTail & RX_BUFFER_MASK];
+    rxTail++;
     return byte;
 }
 
@@ -91,91 +412,214 @@ uint8_t Bluetooth_GetByte(void)
  */
 uint8_t Bluetooth_GetBufferCount(void)
 {
-    if (rxHead >= rxTail) {
-        return rxHead - rxTail;
-    } else {
-        return RX_BUFFER_SIZE - rxTail + rxHead;
-    }
+    uint32_t count = rxHead - rxTail;
+    return (count > RX_BUFFER_SIZE) ? RX_BUFFER_SIZE : (uint8_t)count;
 }
 
-BluetoothCommand Bluetooth_GetCommand(void)
+/**
+ * @brief Map a command from a binary frame (proto.c)
+ */
+static BluetoothCommand Bluetooth_FromProto(const ProtoCommand_t *cmd)
 {
-    if (!Bluetooth_Available()) {
-        return CMD_NONE;
+    if (cmd->id == CMD_NONE || cmd->id >= CMD_UNKNOWN) {
+        return CMD_UNKNOWN;
     }
     
-    uint8_t byte = Bluetooth_GetByte();
-    
-    // Convert to uppercase for easier parsing
-    if (byte >= 'a' && byte <= 'z') {
-        byte = byte - 'a' + 'A';
+    // Binary frames carry the exact speed instead of 10% steps
+    if (cmd->id == CMD_SET_SPEED) {
+        currentSpeed = (cmd->arg > 100) ? 100 : cmd->arg;
     }
+    return (BluetoothCommand)cmd->id;
+}
+
+/**
+ * @brief Single-character ASCII command (fallback protocol)
+ */
+static BluetoothCommand Bluetooth_ParseAscii(uint8_t byte)
+{
+    BluetoothCommand cmd = (BluetoothCommand)asciiCommand[byte];
     
     // Speed setting: digits 1-9 set speed 10%-90%
-    if (byte >= '1' && byte <= '9') {
+    if (cmd == CMD_SET_SPEED) {
         currentSpeed = (byte - '0') * 10;
-        return CMD_SET_SPEED;
-    }
-    
-    // Command parsing
-    switch (byte) {
-        case 'F':
-        case 'W':   // Alternative: W for forward (WASD style)
-            return CMD_FORWARD;
-            
-        case 'B':
-        case 'X':   // Alternative: X for backward
-            return CMD_BACKWARD;
-            
-        case 'L':
-        case 'A':   // Alternative: A for left (WASD style)
-            return CMD_LEFT;
-            
-        case 'R':
-        case 'D':   // Alternative: D for right (WASD style)
-            return CMD_RIGHT;
-            
-        case 'S':
-        case ' ':   // Space for stop
-            return CMD_STOP;
-            
-        case 'O':   // Lights On
-            return CMD_LIGHTS_ON;
-            
-        case 'P':   // Lights Off (P = Power off lights)
-            return CMD_LIGHTS_OFF;
-            
-        case 'M':   // Auto-light Mode toggle
-            return CMD_LIGHTS_AUTO;
-            
-        case 'T':   // Temperature
-            return CMD_GET_TEMP;
-            
-        case 'H':   // Humidity
-            return CMD_GET_HUMIDITY;
-            
-        case 'U':   // Ultrasonic distance
-            return CMD_GET_DISTANCE;
-            
-        case 'I':   // Info (all sensors)
-            return CMD_GET_INFO;
-            
-        case '\r':
-        case '\n':
-        case '\t':
-        case '\0':
-            // Ignore line endings and control characters
-            return CMD_NONE;
-            
-        default:
-            // Ignore any other control characters (0-31)
-            if (byte < 32) {
-                return CMD_NONE;
+    }
+    return cmd;
+}
+
+/**
+ * @brief true (once) when the reader has got past the STOP byte the ISR
+ *        latched on
+ */
+static bool Bluetooth_PassedIsrStop(void)
+{
+    uint32_t primask = DisableGlobalIRQ();
+    bool passed = isrStopPending && (int32_t)(rxTail - isrStopEnd) >= 0;
+    
+    if (passed) {
+        isrStopPending = false;
+        isrStopTaken = true;
+    }
+    EnableGlobalIRQ(primask);
+    return passed;
+}
+
+/**
+ * @brief Next raw command from the ring buffer (no coalescing)
+ * @note The arrival time of the returned command is left in readStampUs
+ * @return CMD_NONE once everything buffered has been consumed
+ */
+static BluetoothCommand Bluetooth_ReadCommand(void)
+{
+    ProtoCommand_t cmd;
+    
+    // Commands left over from the last binary frame come first
+    if (Proto_PopCommand(&cmd)) {
+        readStampUs = frameStampUs;
+        return Bluetooth_FromProto(&cmd);
+    }
+    
+    while (Bluetooth_Available()) {
+        Bluetooth_DropOverwritten();
+        if (Bluetooth_PassedIsrStop()) {
+            readStampUs = rxLastStampUs;
+            return CMD_STOP;  // The latched STOP byte was lost: stand in for it
+        }
+        
+        uint32_t previousUs = rxLastStampUs;
+        uint8_t byte = Bluetooth_GetByte();
+        
+        // A frame the link dropped mid-way must not swallow the ASCII
+        // commands after it: silence before this byte ends frame mode
+        if (Proto_InFrame() && rxLastStampUs - previousUs > PROTO_FRAME_GAP_US) {
+            Proto_Timeout();
+        }
+        
+        // 0x00 opens a binary frame; ASCII terminals never send it
+        if (Proto_InFrame() || byte == PROTO_DELIMITER) {
+            if (Proto_Feed(byte) == PROTO_FRAME_OK && Proto_PopCommand(&cmd)) {
+                frameStampUs = rxLastStampUs;
+                readStampUs = frameStampUs;
+                return Bluetooth_FromProto(&cmd);
             }
-            return CMD_UNKNOWN;
+            continue;
+        }
+        
+        BluetoothCommand ascii = Bluetooth_ParseAscii(byte);
+        if (ascii != CMD_NONE) {
+            if (ascii == CMD_STOP) {
+                Bluetooth_PassedIsrStop();  // This byte, if the ISR latched on it
+            }
+            readStampUs = rxLastStampUs;
+            return ascii;
+        }
+    }
+    
+    if (Bluetooth_PassedIsrStop()) {
+        readStampUs = rxLastStampUs;
+        return CMD_STOP;  // Dropped when the buffer was full
+    }
+    return CMD_NONE;
+}
+
+static inline bool Bluetooth_IsMovement(BluetoothCommand cmd)
+{
+    return (cmd == CMD_FORWARD || cmd == CMD_BACKWARD || cmd == CMD_LEFT || cmd == CMD_RIGHT);
+}
+
+static void Bluetooth_QueueOutput(BluetoothCommand cmd, uint32_t stampUs)
+{
+    if (cmd != CMD_NONE) {
+        outStampUs[outCount] = stampUs;
+        outQueue[outCount++] = cmd;
     }
 }
 
+/**
+ * @brief Hand out the next queued command together with its stamp
+ */
+static BluetoothCommand Bluetooth_NextOutput(void)
+{
+    commandStampUs = outStampUs[outRead];
+    return outQueue[outRead++];
+}
+
+/**
+ * @brief Latest-wins coalescing of movement/speed runs
+ * 
+ * A run of movement and speed commands that is already buffered collapses
+ * into one SET_SPEED (the parser kept the newest speed) followed by the
+ * newest movement. STOP ends a run and is returned straight away; the
+ * movement it cancels is dropped. Any other command ends the run and is
+ * delivered after it. Only data already in the RX buffer is looked at, so
+ * nothing is ever delayed waiting for more bytes.
+ */
+BluetoothCommand Bluetooth_GetCommand(void)
+{
+    if (outRead < outCount) {
+        return Bluetooth_NextOutput();
+    }
+    outRead = 0;
+    outCount = 0;
+    
+    BluetoothCommand cmd = Bluetooth_ReadCommand();
+    if (!Bluetooth_IsMovement(cmd) && cmd != CMD_SET_SPEED) {
+        commandStampUs = readStampUs;
+        return cmd;  // Includes STOP and CMD_NONE
+    }
+    
+    // Each survivor keeps the stamp of the newest command it stands for
+    BluetoothCommand move = Bluetooth_IsMovement(cmd) ? cmd : CMD_NONE;
+    uint32_t moveStampUs = readStampUs;
+    bool speed = (cmd == CMD_SET_SPEED);
+    uint32_t speedStampUs = readStampUs;
+    BluetoothCommand last = CMD_NONE;
+    
+    for (uint8_t n = 0; n < COALESCE_MAX_RUN; n++) {
+        BluetoothCommand next = Bluetooth_ReadCommand();
+        
+        if (Bluetooth_IsMovement(next)) {
+            if (move != CMD_NONE) rxStats.coalesced++;
+            move = next;
+            moveStampUs = readStampUs;
+        } else if (next == CMD_SET_SPEED) {
+            if (speed) rxStats.coalesced++;
+            speed = true;
+            speedStampUs = readStampUs;
+        } else {
+            last = next;  // STOP, other command, or buffer empty
+            break;
+        }
+    }
+    
+    if (last == CMD_STOP) {
+        // STOP goes out first and the movement it overrides is never run
+        if (move != CMD_NONE) rxStats.coalesced++;
+        move = CMD_NONE;
+        Bluetooth_QueueOutput(CMD_STOP, readStampUs);
+        last = CMD_NONE;
+    }
+    if (speed) {
+        Bluetooth_QueueOutput(CMD_SET_SPEED, speedStampUs);
+    }
+    Bluetooth_QueueOutput(move, moveStampUs);
+    Bluetooth_QueueOutput(last, readStampUs);
+    
+    return Bluetooth_NextOutput();
+}
+
+uint32_t Bluetooth_GetCommandTimeUs(void)
+{
+    return commandStampUs;
+}
+
+bool Bluetooth_TakeIsrStop(void)
+{
+    bool taken = isrStopTaken;
+    
+    isrStopTaken = false;
+    return taken;
+}
+
 void Bluetooth_SendString(const char* str)
 {
     UART_SendString(str);
@@ -186,6 +630,11 @@ void Bluetooth_SendNumber(uint32_t num)
     UART_SendNumber(num);
 }
 
+void Bluetooth_SendCenti(uint32_t centi)
+{
+    UART_SendCenti(centi);
+}
+
 void Bluetooth_SendSensorData(const char* label, uint32_t value, const char* unit)
 {
     Bluetooth_SendString(label);
@@ -199,3 +648,10 @@ uint8_t Bluetooth_GetSpeed(void)
 {
     return currentSpeed;
 }
+
+void Bluetooth_GetRxStats(BluetoothRxStats_t *stats)
+{
+    uint32_t primask = DisableGlobalIRQ();
+    *stats = rxStats;
+    EnableGlobalIRQ(primask);
+}
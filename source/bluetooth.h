@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "bluetooth_commands.h"
 
 /**
  * Bluetooth Command Module
@@ -30,26 +31,40 @@
  *   
  *   Speed:
  *     '1'-'9' - Set speed (10%-90%)
+ *   
+ *   Messages:
+ *     'V' - Toggle verbose / compact telemetry (msg.h)
+ * 
+ * The command list itself lives in bluetooth_commands.h.
+ * 
+ * Binary frames (proto.h): a 0x00 byte starts a COBS frame with a CRC16
+ * that can carry several commands and exact speeds (0-100%). The command
+ * ids are the BluetoothCommand values below, so their order is fixed.
  */
 
 typedef enum {
     CMD_NONE = 0,
-    CMD_FORWARD,
-    CMD_BACKWARD,
-    CMD_LEFT,
-    CMD_RIGHT,
-    CMD_STOP,
-    CMD_LIGHTS_ON,
-    CMD_LIGHTS_OFF,
-    CMD_LIGHTS_AUTO,
-    CMD_GET_TEMP,
-    CMD_GET_HUMIDITY,
-    CMD_GET_DISTANCE,
-    CMD_GET_INFO,
-    CMD_SET_SPEED,
+#define BLUETOOTH_ENUM_ENTRY(id, first, last, alt, event, help)  id,
+    BLUETOOTH_COMMAND_LIST(BLUETOOTH_ENUM_ENTRY)
+#undef BLUETOOTH_ENUM_ENTRY
     CMD_UNKNOWN
 } BluetoothCommand;
 
+/**
+ * @brief RX statistics (see Bluetooth_GetRxStats)
+ */
+typedef struct {
+    uint32_t bursts;         // RX interrupts: one per burst (DMA) or per byte
+    uint32_t overflows;      // Bytes lost because the RX buffer was full
+    uint32_t hwOverruns;     // UART overrun errors (byte lost in hardware)
+    uint32_t framingErrors;  // Missing stop bit (baud mismatch / line noise)
+    uint32_t noiseErrors;    // Noise detected while sampling a bit
+    uint32_t parityErrors;   // Parity errors (only if parity is enabled)
+    uint32_t coalesced;      // Stale movement/speed commands merged away
+    uint32_t emergencyStops;    // STOP bytes acted on in the UART0 ISR
+    uint32_t stopLatencyMaxUs;  // Worst STOP byte -> motor pins off (see bluetooth.c)
+} BluetoothRxStats_t;
+
 /**
  * @brief Initialize Bluetooth UART communication
  * @note UART0 should already be initialized by BOARD_InitDebugConsole()
@@ -69,11 +84,28 @@ bool Bluetooth_Available(void);
 uint8_t Bluetooth_GetByte(void);
 
 /**
- * @brief Parse received byte and return command
- * @return Command enum value
+ * @brief Parse received bytes (ASCII or binary frame) and return a command
+ * @note Buffered runs of movement/speed commands are coalesced: only the
+ *       newest speed and movement are returned. STOP is never delayed.
+ * @return Command enum value, CMD_NONE if nothing complete was received
  */
 BluetoothCommand Bluetooth_GetCommand(void);
 
+/**
+ * @brief Arrival time of the command Bluetooth_GetCommand() returned last
+ * @return Timebase_GetUs() at the end of the byte that completed it
+ *         (for a coalesced run: the newest command kept)
+ */
+uint32_t Bluetooth_GetCommandTimeUs(void);
+
+/**
+ * @brief true (once) if the STOP Bluetooth_GetCommand() returned last is
+ *        the one the UART0 ISR already acted on (Motor_EmergencyStop)
+ * @note Also true for the STOP handed out in place of a latched STOP byte
+ *       that was lost to an RX overflow
+ */
+bool Bluetooth_TakeIsrStop(void);
+
 /**
  * @brief Send a string via Bluetooth
  * @param str Null-terminated string to send
@@ -86,6 +118,12 @@ void Bluetooth_SendString(const char* str);
  */
 void Bluetooth_SendNumber(uint32_t num);
 
+/**
+ * @brief Send a centi-unit value as "whole.ff"
+ * @param centi Value x 100 (e.g. DHT11 temperature)
+ */
+void Bluetooth_SendCenti(uint32_t centi);
+
 /**
  * @brief Send formatted sensor data
  * @param label Sensor name
@@ -100,6 +138,12 @@ void Bluetooth_SendSensorData(const char* label, uint32_t value, const char* uni
  */
 uint8_t Bluetooth_GetBufferCount(void);
 
+/**
+ * @brief Get a snapshot of the RX overflow and line error counters
+ * @param stats Filled with the current counters
+ */
+void Bluetooth_GetRxStats(BluetoothRxStats_t *stats);
+
 /**
  * @brief Get current speed setting (0-100)
  * @return Speed percentage
@@ -0,0 +1,49 @@
+#ifndef BLUETOOTH_COMMANDS_H
+#define BLUETOOTH_COMMANDS_H
+
+/**
+ * Bluetooth Command Definitions (single source of truth)
+ * 
+ * Every command is listed once here. The list generates:
+ *   - the BluetoothCommand enum (bluetooth.h)
+ *   - the 256-entry byte -> command lookup table (bluetooth.c)
+ *   - the help banner (BLUETOOTH_HELP_TEXT)
+ *   - the command -> FSM event table (PROIECT.c)
+ * 
+ * Columns:
+ *   id     BluetoothCommand name. The order is the binary protocol id
+ *          (proto.h), so only ever append new commands.
+ *   first  First character of the key range (uppercase)
+ *   last   Last character of the key range (same as first for one key)
+ *   alt    Alternative key (same as first if there is none)
+ *   event  FSM event, EVENT_NONE for commands handled outside the FSM
+ *   help   Banner text; entries concatenate, "\r\n" ends a banner line
+ * 
+ * Letter keys are matched case-insensitively.
+ */
+
+#define BLUETOOTH_COMMAND_LIST(X) \
+    X(CMD_FORWARD,      'F', 'F', 'W', EVENT_CMD_FORWARD,  "  F/W=Forward")                 \
+    X(CMD_BACKWARD,     'B', 'B', 'X', EVENT_CMD_BACKWARD, " B/X=Back")                     \
+    X(CMD_LEFT,         'L', 'L', 'A', EVENT_CMD_LEFT,     " L/A=Left")                     \
+    X(CMD_RIGHT,        'R', 'R', 'D', EVENT_CMD_RIGHT,    " R/D=Right")                    \
+    X(CMD_STOP,         'S', 'S', ' ', EVENT_CMD_STOP,     " S=Stop\r\n")                   \
+    X(CMD_LIGHTS_ON,    'O', 'O', 'O', EVENT_NONE,         "  O=LightsON")                  \
+    X(CMD_LIGHTS_OFF,   'P', 'P', 'P', EVENT_NONE,         " P=LightsOFF")                  \
+    X(CMD_LIGHTS_AUTO,  'M', 'M', 'M', EVENT_NONE,         " M=AutoMode\r\n")               \
+    X(CMD_GET_TEMP,     'T', 'T', 'T', EVENT_NONE,         "  T=Temp")                      \
+    X(CMD_GET_HUMIDITY, 'H', 'H', 'H', EVENT_NONE,         " H=Humidity")                   \
+    X(CMD_GET_DISTANCE, 'U', 'U', 'U', EVENT_NONE,         " U=Distance")                   \
+    X(CMD_GET_INFO,     'I', 'I', 'I', EVENT_NONE,         " I=Info\r\n")                   \
+    X(CMD_SET_SPEED,    '1', '9', '1', EVENT_NONE,         "  1-9=Set Speed (10%-90%)\r\n")  \
+    X(CMD_MSG_MODE,     'V', 'V', 'V', EVENT_NONE,         "  V=Verbose/compact messages\r\n") \
+    X(CMD_PROF_DUMP,    'Z', 'Z', 'Z', EVENT_NONE,         "  Z=Profiler dump (binary)\r\n")
+
+// Lowercase form of a key character (non-letters map to themselves)
+#define BLUETOOTH_KEY_LOWER(c)  ((((c) >= 'A') && ((c) <= 'Z')) ? ((c) + ('a' - 'A')) : (c))
+
+// Help banner: one string literal in flash
+#define BLUETOOTH_HELP_ENTRY(id, first, last, alt, event, help)  help
+#define BLUETOOTH_HELP_TEXT     BLUETOOTH_COMMAND_LIST(BLUETOOTH_HELP_ENTRY)
+
+#endif // BLUETOOTH_COMMANDS_H
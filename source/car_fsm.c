@@ -2,6 +2,10 @@
 #include "motor.h"
 #include "bluetooth.h"
 #include "uart.h"
+#include "msg.h"
+#include "events.h"
+#include "swtimer.h"
+#include "prof.h"
 #include "MKL25Z4.h"
 #include "fsl_clock.h"
 
@@ -12,47 +16,36 @@
  * - IDLE -> FORWARD/BACKWARD/LEFT/RIGHT via Bluetooth commands
  * - FORWARD -> IDLE on obstacle detection or STOP command
  * - Any moving state -> IDLE on STOP command
- * - LEFT/RIGHT: 90-degree pivot turn (non-blocking via PIT timer)
+ * - LEFT/RIGHT: 90-degree pivot turn (non-blocking via a software timer)
  * - Moving states can transition directly between each other
+ * 
+ * FSM_ProcessEvent is one lookup in the const transition matrix below;
+ * per-state actions (motor drive, message, turn timer) are in stateInfo.
  */
 
 // Turn duration in milliseconds (adjust for 90-degree turn)
 #define TURN_DURATION_MS  400U
 
+// How obstacle stops take the speed off (TRANS_BRAKE); coasting rolls on
+// into the obstacle, see tools/brake_sim for the stopping distances
+#define OBSTACLE_STOP_POLICY  MOTOR_STOP_BRAKE_COAST
+
 // FSM State
 static CarState_t g_currentState = STATE_IDLE;
 static uint8_t g_currentSpeed = 0;  // Will be set from Motor_GetDefaultSpeed()
 
-// Turn timer flag - set by PIT interrupt when turn is complete
-static volatile bool g_turnComplete = false;
-static volatile bool g_turnActive = false;
-
-// State name strings for debugging
-static const char* stateNames[] = {
-    "IDLE",
-    "FORWARD",
-    "BACKWARD",
-    "LEFT",
-    "RIGHT"
-};
+// Turn id - the turn timer ISR posts it with EVENT_TURN_COMPLETE so a stale
+// completion (turn already cancelled or restarted) is ignored
+static volatile uint16_t g_turnId = 0;
+static SwTimer_t g_turnTimer;
 
 /**
- * @brief Initialize PIT channel 0 for turn timing
+ * @brief Turn time is over (software timer callback, TPM2 ISR)
  */
-static void TurnTimer_Init(void)
+static void TurnTimer_Expired(void *arg)
 {
-    // Enable PIT clock
-    SIM->SCGC6 |= SIM_SCGC6_PIT_MASK;
-    
-    // Enable PIT module
-    PIT->MCR = 0;  // Enable PIT, do not freeze in debug
-    
-    // Disable PIT0 initially
-    PIT->CHANNEL[0].TCTRL = 0;
-    
-    // Enable PIT0 interrupt in NVIC
-    NVIC_EnableIRQ(PIT_IRQn);
-    NVIC_SetPriority(PIT_IRQn, 2);
+    (void)arg;
+    Events_Post(EVENT_SRC_TIMER, EVENT_TURN_COMPLETE, g_turnId);
 }
 
 /**
@@ -60,18 +53,8 @@ static void TurnTimer_Init(void)
  */
 static void TurnTimer_Start(void)
 {
-    // Calculate LDVAL for desired duration
-    // PIT clock = Bus clock = 24MHz (CLOCK_GetBusClkFreq())
-    uint32_t busClk = CLOCK_GetBusClkFreq();
-    uint32_t loadVal = (busClk / 1000) * TURN_DURATION_MS - 1;
-    
-    g_turnComplete = false;
-    g_turnActive = true;
-    
-    // Configure PIT0
-    PIT->CHANNEL[0].LDVAL = loadVal;
-    PIT->CHANNEL[0].TFLG = PIT_TFLG_TIF_MASK;  // Clear any pending flag
-    PIT->CHANNEL[0].TCTRL = PIT_TCTRL_TIE_MASK | PIT_TCTRL_TEN_MASK;  // Enable timer + interrupt
+    g_turnId++;
+    SwTimer_Start(&g_turnTimer, TURN_DURATION_MS, 0);
 }
 
 /**
@@ -79,188 +62,136 @@ static void TurnTimer_Start(void)
  */
 static void TurnTimer_Stop(void)
 {
-    PIT->CHANNEL[0].TCTRL = 0;  // Disable timer
-    g_turnActive = false;
+    SwTimer_Stop(&g_turnTimer);
+    g_turnId++;                 // Invalidate a completion already queued
 }
 
 /**
- * @brief Execute action for entering a state
+ * @brief Drive "action" for IDLE (same signature as the Motor_* functions)
  */
-static void FSM_EnterState(CarState_t newState)
+static void FSM_DriveStop(uint8_t speed)
 {
-    g_currentState = newState;
-    
-    switch (newState) {
-        case STATE_IDLE:
-            Motor_Stop();
-            Bluetooth_SendString(">> State: IDLE\r\n");
-            break;
-            
-        case STATE_FORWARD:
-            Motor_Forward(g_currentSpeed);
-            Bluetooth_SendString(">> State: FORWARD\r\n");
-            break;
-            
-        case STATE_BACKWARD:
-            Motor_Backward(g_currentSpeed);
-            Bluetooth_SendString(">> State: BACKWARD\r\n");
-            break;
-            
-        case STATE_LEFT:
-            Bluetooth_SendString(">> Pivot LEFT 90deg...\r\n");
-            Motor_TurnLeft(g_currentSpeed);
-            TurnTimer_Start();  // Non-blocking timer
-            break;
-            
-        case STATE_RIGHT:
-            Bluetooth_SendString(">> Pivot RIGHT 90deg...\r\n");
-            Motor_TurnRight(g_currentSpeed);
-            TurnTimer_Start();  // Non-blocking timer
-            break;
-    }
+    (void)speed;
+    Motor_Stop();
 }
 
 /**
- * @brief Handle events when in IDLE state
+ * @brief Per-state actions
  */
-static void FSM_HandleIdleState(CarEvent_t event)
-{
-    switch (event) {
-        case EVENT_CMD_FORWARD:
-            FSM_EnterState(STATE_FORWARD);
-            break;
-        case EVENT_CMD_BACKWARD:
-            FSM_EnterState(STATE_BACKWARD);
-            break;
-        case EVENT_CMD_LEFT:
-            FSM_EnterState(STATE_LEFT);
-            break;
-        case EVENT_CMD_RIGHT:
-            FSM_EnterState(STATE_RIGHT);
-            break;
-        default:
-            // Ignore other events in IDLE
-            break;
-    }
-}
+typedef struct {
+    const char *name;               // For debugging / sensor info
+    MsgId_t enterMsg;               // Sent on entry
+    void (*drive)(uint8_t speed);   // Motor action on entry and refresh
+    void (*onEnter)(void);          // Extra entry action (optional)
+    void (*onExit)(void);           // Exit action (optional)
+} StateInfo_t;
+
+static const StateInfo_t stateInfo[STATE_COUNT] = {
+    [STATE_IDLE]     = { "IDLE",     MSG_STATE_IDLE,     FSM_DriveStop,   NULL,            NULL           },
+    [STATE_FORWARD]  = { "FORWARD",  MSG_STATE_FORWARD,  Motor_Forward,   NULL,            NULL           },
+    [STATE_BACKWARD] = { "BACKWARD", MSG_STATE_BACKWARD, Motor_Backward,  NULL,            NULL           },
+    [STATE_LEFT]     = { "LEFT",     MSG_PIVOT_LEFT,     Motor_TurnLeft,  TurnTimer_Start, TurnTimer_Stop },
+    [STATE_RIGHT]    = { "RIGHT",    MSG_PIVOT_RIGHT,    Motor_TurnRight, TurnTimer_Start, TurnTimer_Stop },
+};
 
 /**
- * @brief Handle events when in FORWARD state
- * Special handling: obstacle detection causes immediate stop + alert
+ * @brief What an event does in a given state
  */
-static void FSM_HandleForwardState(CarEvent_t event)
-{
-    switch (event) {
-        case EVENT_OBSTACLE:
-            // Obstacle detected! Stop immediately and alert
-            FSM_EnterState(STATE_IDLE);
-            // Alert is sent by caller with distance info
-            break;
-        case EVENT_CMD_STOP:
-            FSM_EnterState(STATE_IDLE);
-            break;
-        case EVENT_CMD_BACKWARD:
-            FSM_EnterState(STATE_BACKWARD);
-            break;
-        case EVENT_CMD_LEFT:
-            FSM_EnterState(STATE_LEFT);
-            break;
-        case EVENT_CMD_RIGHT:
-            FSM_EnterState(STATE_RIGHT);
-            break;
-        case EVENT_CMD_FORWARD:
-            // Already forward, maybe update speed?
-            Motor_Forward(g_currentSpeed);
-            break;
-        default:
-            break;
-    }
-}
+typedef enum {
+    TRANS_IGNORE = 0,   // Nothing (default for unlisted pairs)
+    TRANS_ENTER,        // Exit current state, enter 'next'
+    TRANS_REFRESH,      // Same state again: re-apply the drive action only
+    TRANS_BRAKE         // Brake (OBSTACLE_STOP_POLICY), then enter 'next'
+} TransitionKind_t;
+
+typedef struct {
+    uint8_t kind;       // TransitionKind_t
+    uint8_t next;       // CarState_t (TRANS_ENTER / TRANS_BRAKE only)
+    uint8_t msg;        // MsgId_t + 1 replacing the entry message, 0 = none
+} Transition_t;
+
+#define ENTER(state)            { TRANS_ENTER, (state), 0 }
+#define ENTER_MSG(state, msg)   { TRANS_ENTER, (state), (msg) + 1 }
+#define REFRESH                 { TRANS_REFRESH, 0, 0 }
+#define BRAKE(state)            { TRANS_BRAKE, (state), 0 }
 
 /**
- * @brief Handle events when in BACKWARD state
- * Obstacle detection added for rear sensor
+ * Transition matrix [state][event]
+ * - Movement commands switch directly between moving states
+ * - Repeating the current movement refreshes the motors (speed update)
+ * - STOP returns to IDLE; obstacles only matter while driving straight
+ *   and brake instead of coasting
  */
-static void FSM_HandleBackwardState(CarEvent_t event)
-{
-    switch (event) {
-        case EVENT_OBSTACLE:
-            // Rear obstacle detected! Stop immediately
-            FSM_EnterState(STATE_IDLE);
-            break;
-        case EVENT_CMD_STOP:
-            FSM_EnterState(STATE_IDLE);
-            break;
-        case EVENT_CMD_FORWARD:
-            FSM_EnterState(STATE_FORWARD);
-            break;
-        case EVENT_CMD_LEFT:
-            FSM_EnterState(STATE_LEFT);
-            break;
-        case EVENT_CMD_RIGHT:
-            FSM_EnterState(STATE_RIGHT);
-            break;
-        case EVENT_CMD_BACKWARD:
-            // Already backward, maybe update speed?
-            Motor_Backward(g_currentSpeed);
-            break;
-        default:
-            break;
-    }
-}
+static const Transition_t transitions[STATE_COUNT][EVENT_COUNT] = {
+    [STATE_IDLE] = {
+        [EVENT_CMD_FORWARD]  = ENTER(STATE_FORWARD),
+        [EVENT_CMD_BACKWARD] = ENTER(STATE_BACKWARD),
+        [EVENT_CMD_LEFT]     = ENTER(STATE_LEFT),
+        [EVENT_CMD_RIGHT]    = ENTER(STATE_RIGHT),
+    },
+    [STATE_FORWARD] = {
+        [EVENT_CMD_FORWARD]  = REFRESH,
+        [EVENT_CMD_BACKWARD] = ENTER(STATE_BACKWARD),
+        [EVENT_CMD_LEFT]     = ENTER(STATE_LEFT),
+        [EVENT_CMD_RIGHT]    = ENTER(STATE_RIGHT),
+        [EVENT_CMD_STOP]     = ENTER(STATE_IDLE),
+        [EVENT_OBSTACLE]     = BRAKE(STATE_IDLE),  // Alert is sent by caller with distance info
+    },
+    [STATE_BACKWARD] = {
+        [EVENT_CMD_FORWARD]  = ENTER(STATE_FORWARD),
+        [EVENT_CMD_BACKWARD] = REFRESH,
+        [EVENT_CMD_LEFT]     = ENTER(STATE_LEFT),
+        [EVENT_CMD_RIGHT]    = ENTER(STATE_RIGHT),
+        [EVENT_CMD_STOP]     = ENTER(STATE_IDLE),
+        [EVENT_OBSTACLE]     = BRAKE(STATE_IDLE),  // Rear obstacle
+    },
+    [STATE_LEFT] = {
+        [EVENT_CMD_FORWARD]  = ENTER(STATE_FORWARD),
+        [EVENT_CMD_BACKWARD] = ENTER(STATE_BACKWARD),
+        [EVENT_CMD_LEFT]     = REFRESH,
+        [EVENT_CMD_RIGHT]    = ENTER(STATE_RIGHT),
+        [EVENT_CMD_STOP]     = ENTER(STATE_IDLE),
+        [EVENT_TURN_COMPLETE] = ENTER_MSG(STATE_IDLE, MSG_TURN_COMPLETE),
+    },
+    [STATE_RIGHT] = {
+        [EVENT_CMD_FORWARD]  = ENTER(STATE_FORWARD),
+        [EVENT_CMD_BACKWARD] = ENTER(STATE_BACKWARD),
+        [EVENT_CMD_LEFT]     = ENTER(STATE_LEFT),
+        [EVENT_CMD_RIGHT]    = REFRESH,
+        [EVENT_CMD_STOP]     = ENTER(STATE_IDLE),
+        [EVENT_TURN_COMPLETE] = ENTER_MSG(STATE_IDLE, MSG_TURN_COMPLETE),
+    },
+};
+
+#undef ENTER
+#undef ENTER_MSG
+#undef REFRESH
+#undef BRAKE
 
 /**
- * @brief Handle events when in LEFT state
+ * @brief Run exit action of the current state, then entry actions of the new one
+ * @param msg Message to send instead of the state's entry message
  */
-static void FSM_HandleLeftState(CarEvent_t event)
+static void FSM_EnterStateWithMsg(CarState_t newState, MsgId_t msg)
 {
-    switch (event) {
-        case EVENT_CMD_STOP:
-            FSM_EnterState(STATE_IDLE);
-            break;
-        case EVENT_CMD_FORWARD:
-            FSM_EnterState(STATE_FORWARD);
-            break;
-        case EVENT_CMD_BACKWARD:
-            FSM_EnterState(STATE_BACKWARD);
-            break;
-        case EVENT_CMD_RIGHT:
-            FSM_EnterState(STATE_RIGHT);
-            break;
-        case EVENT_CMD_LEFT:
-            // Already turning left
-            Motor_TurnLeft(g_currentSpeed);
-            break;
-        default:
-            break;
+    const StateInfo_t *info = &stateInfo[newState];
+    
+    if (stateInfo[g_currentState].onExit) {
+        stateInfo[g_currentState].onExit();
+    }
+    
+    g_currentState = newState;
+    
+    info->drive(g_currentSpeed);
+    Msg_Send(msg);
+    if (info->onEnter) {
+        info->onEnter();
     }
 }
 
-/**
- * @brief Handle events when in RIGHT state
- */
-static void FSM_HandleRightState(CarEvent_t event)
+static void FSM_EnterState(CarState_t newState)
 {
-    switch (event) {
-        case EVENT_CMD_STOP:
-            FSM_EnterState(STATE_IDLE);
-            break;
-        case EVENT_CMD_FORWARD:
-            FSM_EnterState(STATE_FORWARD);
-            break;
-        case EVENT_CMD_BACKWARD:
-            FSM_EnterState(STATE_BACKWARD);
-            break;
-        case EVENT_CMD_LEFT:
-            FSM_EnterState(STATE_LEFT);
-            break;
-        case EVENT_CMD_RIGHT:
-            // Already turning right
-            Motor_TurnRight(g_currentSpeed);
-            break;
-        default:
-            break;
-    }
+    FSM_EnterStateWithMsg(newState, stateInfo[newState].enterMsg);
 }
 
 // ============================================
@@ -271,37 +202,39 @@ void FSM_Init(void)
 {
     g_currentState = STATE_IDLE;
     g_currentSpeed = Motor_GetDefaultSpeed();  // Get default from motor.c
-    g_turnComplete = false;
-    g_turnActive = false;
     
-    TurnTimer_Init();  // Initialize PIT for turn timing
+    SwTimer_Setup(&g_turnTimer, TurnTimer_Expired, NULL);
     Motor_Stop();
     UART_SendString("  FSM initialized (IDLE)\r\n");
 }
 
 void FSM_ProcessEvent(CarEvent_t event)
 {
-    if (event == EVENT_NONE) {
+    if (event == EVENT_NONE || event >= EVENT_COUNT) {
         return;
     }
     
-    switch (g_currentState) {
-        case STATE_IDLE:
-            FSM_HandleIdleState(event);
-            break;
-        case STATE_FORWARD:
-            FSM_HandleForwardState(event);
-            break;
-        case STATE_BACKWARD:
-            FSM_HandleBackwardState(event);
-            break;
-        case STATE_LEFT:
-            FSM_HandleLeftState(event);
-            break;
-        case STATE_RIGHT:
-            FSM_HandleRightState(event);
-            break;
+    const Transition_t *t = &transitions[g_currentState][event];
+    
+    if (t->kind == TRANS_IGNORE) {
+        return;
+    }
+    
+    PROF_START(startUs);
+    if (t->kind == TRANS_BRAKE) {
+        // Brake first; IDLE's Motor_Stop() then leaves the brake on
+        Motor_StopWith(OBSTACLE_STOP_POLICY);
+        FSM_EnterState((CarState_t)t->next);
+    } else if (t->kind == TRANS_ENTER) {
+        if (t->msg != 0) {
+            FSM_EnterStateWithMsg((CarState_t)t->next, (MsgId_t)(t->msg - 1));
+        } else {
+            FSM_EnterState((CarState_t)t->next);
+        }
+    } else {
+        stateInfo[g_currentState].drive(g_currentSpeed);  // TRANS_REFRESH
     }
+    PROF_END(PROF_FSM_EVENT, startUs);
 }
 
 CarState_t FSM_GetState(void)
@@ -311,8 +244,8 @@ CarState_t FSM_GetState(void)
 
 const char* FSM_GetStateName(CarState_t state)
 {
-    if (state <= STATE_RIGHT) {
-        return stateNames[state];
+    if (state < STATE_COUNT) {
+        return stateInfo[state].name;
     }
     return "UNKNOWN";
 }
@@ -323,21 +256,8 @@ void FSM_SetSpeed(uint8_t speed)
     g_currentSpeed = speed;
     
     // Update motor speed if currently moving
-    switch (g_currentState) {
-        case STATE_FORWARD:
-            Motor_Forward(g_currentSpeed);
-            break;
-        case STATE_BACKWARD:
-            Motor_Backward(g_currentSpeed);
-            break;
-        case STATE_LEFT:
-            Motor_TurnLeft(g_currentSpeed);
-            break;
-        case STATE_RIGHT:
-            Motor_TurnRight(g_currentSpeed);
-            break;
-        default:
-            break;
+    if (g_currentState != STATE_IDLE) {
+        stateInfo[g_currentState].drive(g_currentSpeed);
     }
 }
 
@@ -358,48 +278,32 @@ void FSM_StopCar(void)
 
 void FSM_SendObstacleAlert(uint32_t distanceCm)
 {
-    Bluetooth_SendString("!! OBSTACLE at ");
-    Bluetooth_SendNumber(distanceCm);
-    Bluetooth_SendString(" cm - STOPPED !!\r\n");
+    Msg_Send(MSG_OBSTACLE_FRONT, distanceCm);
 }
 
 /**
  * @brief Update FSM - call this from main loop
- * Checks if turn is complete and transitions to IDLE
+ * Drains every queued event (ISRs and main loop) oldest first
  */
 void FSM_Update(void)
 {
-    if (g_turnComplete && (g_currentState == STATE_LEFT || g_currentState == STATE_RIGHT)) {
-        Motor_Stop();
-        g_currentState = STATE_IDLE;
-        g_turnComplete = false;
-        Bluetooth_SendString(">> Turn complete -> IDLE\r\n");
-    }
-}
-
-/**
- * @brief PIT Interrupt Handler
- * Called when turn timer expires
- */
-void PIT_IRQHandler(void)
-{
-    // Check if PIT0 caused interrupt (FSM turn timer)
-    if (PIT->CHANNEL[0].TFLG & PIT_TFLG_TIF_MASK) {
-        // Clear interrupt flag
-        PIT->CHANNEL[0].TFLG = PIT_TFLG_TIF_MASK;
+    QueuedEvent_t queued;
+    
+    while (Events_Get(&queued)) {
+        PROF_END(PROF_EVENT_AGE, queued.timeUs);
         
-        // Disable timer (one-shot)
-        PIT->CHANNEL[0].TCTRL = 0;
+        // Completion of a turn that has since been cancelled or restarted
+        if (queued.event == EVENT_TURN_COMPLETE && queued.arg != g_turnId) {
+            continue;
+        }
         
-        // Set completion flag
-        g_turnComplete = true;
-        g_turnActive = false;
-    }
-    
-    // Check if PIT1 caused interrupt (Motor test turn timer)
-    if (PIT->CHANNEL[1].TFLG & PIT_TFLG_TIF_MASK) {
-        // Forward to test handler defined in PROIECT.c
-        extern void TestTurnTimer_IRQHandler(void);
-        TestTurnTimer_IRQHandler();
+        // Commands carry their byte arrival time: trace it to the PWM write
+        if (queued.event >= EVENT_CMD_FORWARD && queued.event <= EVENT_CMD_STOP) {
+            Motor_TraceCommand(queued.originUs);
+            FSM_ProcessEvent((CarEvent_t)queued.event);
+            Motor_TraceEnd();
+        } else {
+            FSM_ProcessEvent((CarEvent_t)queued.event);
+        }
     }
 }
@@ -11,6 +11,8 @@
  * - 5 states: IDLE, FORWARD, BACKWARD, LEFT, RIGHT
  * - Events from Bluetooth commands and obstacle sensor
  * - Automatic obstacle detection and alerting when moving forward
+ * - Transitions and state actions are const tables (car_fsm.c): a new
+ *   state is one row in each, not a new handler function
  */
 
 /**
@@ -21,7 +23,8 @@ typedef enum {
     STATE_FORWARD,      // Car is moving forward (obstacle detection active)
     STATE_BACKWARD,     // Car is moving backward
     STATE_LEFT,         // Car is turning left
-    STATE_RIGHT         // Car is turning right
+    STATE_RIGHT,        // Car is turning right
+    STATE_COUNT         // Number of states (table size, not a state)
 } CarState_t;
 
 /**
@@ -34,8 +37,10 @@ typedef enum {
     EVENT_CMD_LEFT,         // Bluetooth command: Left (L/A)
     EVENT_CMD_RIGHT,        // Bluetooth command: Right (R/D)
     EVENT_CMD_STOP,         // Bluetooth command: Stop (S/space)
-    EVENT_OBSTACLE,         // Obstacle detected (<20cm)
-    EVENT_OBSTACLE_CLEAR    // Obstacle cleared
+    EVENT_OBSTACLE,         // Obstacle inside the stopping distance (ttc.h)
+    EVENT_OBSTACLE_CLEAR,   // Obstacle cleared
+    EVENT_TURN_COMPLETE,    // Turn timer expired (timer ISR, arg = turn id)
+    EVENT_COUNT             // Number of events (table size, not an event)
 } CarEvent_t;
 
 /**
@@ -95,7 +100,8 @@ void FSM_SendObstacleAlert(uint32_t distanceCm);
 
 /**
  * @brief Update FSM state machine
- * Must be called from main loop to handle non-blocking turn completion
+ * Must be called from main loop: drains the event queues (events.h)
+ * in order, including turn completion posted by the turn timer ISR
  */
 void FSM_Update(void);
 
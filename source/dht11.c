@@ -5,11 +5,13 @@
 #include "board.h"
 #include "MKL25Z4.h"
 #include "uart.h"
+#include "timebase.h"
 
 /**
- * DHT11 Temperature & Humidity Sensor using TPM1 for precise timing
+ * DHT11 Temperature & Humidity Sensor
  * 
- * Uses TPM1 as free-running counter for microsecond-level timing
+ * Pulse widths and timeouts are measured on the shared microsecond
+ * timebase (timebase.h), which keeps counting with interrupts masked.
  * PTD4 for DHT11 data pin
  */
 
@@ -19,80 +21,11 @@
 #define DHT11_PIN       4U
 #define DHT11_PIN_MASK  (1U << DHT11_PIN)
 
-// TPM1 configuration: 48MHz / 1 = 48MHz, 1 tick = 20.83ns
-// But we'll use prescaler 16: 48MHz / 16 = 3MHz, 1 tick = 0.333us
-// Or prescaler 48: 48MHz / 48 = 1MHz, 1 tick = 1us (ideal!)
-// Using prescaler 32 (PS=5): 48MHz / 32 = 1.5MHz, ~0.667us per tick
-#define TPM1_PRESCALER      4U          // PS=4 means divide by 16: 48MHz/16 = 3MHz
-#define TICKS_PER_US        3U          // 3 ticks per microsecond at 3MHz
+// Bit 0 = ~26-28us HIGH, bit 1 = ~70us HIGH
+#define DHT11_BIT1_THRESHOLD_US 40U
 
-/**
- * @brief Get current TPM1 counter value
- */
-static inline uint16_t DHT11_GetTicks(void)
-{
-    return (uint16_t)(TPM1->CNT & 0xFFFF);
-}
-
-/**
- * @brief Calculate elapsed ticks (handles 16-bit overflow)
- */
-static inline uint16_t DHT11_ElapsedTicks(uint16_t start, uint16_t end)
-{
-    return (uint16_t)(end - start);
-}
-
-/**
- * @brief Delay in microseconds using TPM1 hardware timer
- */
-static void DHT11_DelayUs(uint32_t us)
-{
-    uint16_t startTicks = DHT11_GetTicks();
-    uint16_t delayTicks = (uint16_t)(us * TICKS_PER_US);
-    
-    while (DHT11_ElapsedTicks(startTicks, DHT11_GetTicks()) < delayTicks) {
-        // Busy wait using hardware timer
-    }
-}
-
-/**
- * @brief Delay in milliseconds
- */
-static void DHT11_DelayMs(uint32_t ms)
-{
-    while (ms--) {
-        DHT11_DelayUs(1000);
-    }
-}
-
-/**
- * @brief Initialize TPM1 for timing
- */
-static void DHT11_InitTimer(void)
-{
-    // Enable TPM1 clock gate
-    SIM->SCGC6 |= SIM_SCGC6_TPM1_MASK;
-    
-    // TPM clock source = PLLFLLCLK (48MHz)
-    SIM->SOPT2 = (SIM->SOPT2 & ~SIM_SOPT2_TPMSRC_MASK) | SIM_SOPT2_TPMSRC(1);
-    
-    // Stop TPM1 before configuring
-    TPM1->SC = 0;
-    
-    // Reset counter
-    TPM1->CNT = 0;
-    
-    // Set prescaler to divide by 16 (PS=4): 48MHz / 16 = 3MHz
-    TPM1->SC = TPM_SC_PS(TPM1_PRESCALER);
-    
-    // Set MOD to maximum for free-running mode
-    TPM1->MOD = 0xFFFF;
-    
-    // Start TPM1 with internal clock
-    TPM1->SC |= TPM_SC_CMOD(1);
-    
-    UART_SendString("  TPM1 timer configured (3MHz, DHT11)\r\n");
-}
+// Longest any level of the response or a data bit may last
+#define DHT11_LEVEL_TIMEOUT_US  200U
 
 // GPIO pin control
 static void DHT11_SetPinOutput(void)
@@ -119,14 +52,30 @@ static uint8_t DHT11_PinRead(void)
     return (DHT11_GPIO->PDIR & DHT11_PIN_MASK) ? 1 : 0;
 }
 
+/**
+ * @brief Wait while the pin stays at level
+ * @return Time spent at level in us, or 0 on timeout
+ */
+static uint32_t DHT11_WaitWhile(uint8_t level)
+{
+    uint32_t start = Timebase_GetUs();
+    uint32_t elapsed;
+    
+    while (DHT11_PinRead() == level) {
+        elapsed = Timebase_ElapsedUs(start);
+        if (elapsed > DHT11_LEVEL_TIMEOUT_US) {
+            return 0;
+        }
+    }
+    elapsed = Timebase_ElapsedUs(start);
+    return elapsed ? elapsed : 1U;
+}
+
 /**
  * @brief Initialize DHT11 sensor
  */
 void DHT11_Init(void)
 {
-    // Initialize timer first
-    DHT11_InitTimer();
-    
     // Enable Port D clock
     CLOCK_EnableClock(kCLOCK_PortD);
     
@@ -141,9 +90,9 @@ void DHT11_Init(void)
     DHT11_PinWrite(1);
     
     // Wait for sensor stabilization (1 second)
-    DHT11_DelayMs(1000);
+    Timebase_DelayMs(1000);
 
-    UART_SendString("  DHT11 init finish (TPM1 timing)\r\n");
+    UART_SendString("  DHT11 init finish (timebase timing)\r\n");
 }
 
 const char *DHT11_GetErrorString(DHT11_ErrorCode code)
@@ -167,31 +116,17 @@ static uint8_t DHT11_ReadByte(void)
 {
     uint8_t byte = 0;
     uint8_t i;
-    uint16_t timeout;
-    uint16_t highTime;
+    uint32_t highTime;
 
     for (i = 0; i < 8; i++) {
         // Wait for pin to go HIGH (start of data bit)
-        timeout = 200;
-        while (!DHT11_PinRead() && timeout--) {
-            DHT11_DelayUs(1);
-        }
+        DHT11_WaitWhile(0);
 
         // Measure how long the pin stays HIGH
-        uint16_t startTicks = DHT11_GetTicks();
+        highTime = DHT11_WaitWhile(1);
         
-        timeout = 200;
-        while (DHT11_PinRead() && timeout--) {
-            DHT11_DelayUs(1);
-        }
-        
-        highTime = DHT11_ElapsedTicks(startTicks, DHT11_GetTicks());
-        
-        // Convert to microseconds: highTime / TICKS_PER_US
-        // Bit 0 = ~26-28us HIGH, Bit 1 = ~70us HIGH
-        // Threshold at ~40us = 120 ticks at 3MHz
         byte <<= 1;
-        if (highTime > 120) {  // > 40us means bit 1
+        if (highTime > DHT11_BIT1_THRESHOLD_US) {
             byte |= 1;
         }
     }
@@ -203,50 +138,37 @@ DHT11_ErrorCode DHT11_Read(uint16_t *temperatureCentigrade, uint16_t *humidityCe
 {
     uint8_t buffer[5];
     uint8_t checksum;
-    uint16_t timeout;
-    
-    // Disable interrupts for critical timing section
-    __disable_irq();
     
     // === Send start signal ===
-    // MCU pulls LOW for 20ms
+    // MCU pulls LOW for 20ms (>= 18ms, not timing critical: interrupts stay on)
     DHT11_SetPinOutput();
     DHT11_PinWrite(0);
-    DHT11_DelayMs(20);
+    Timebase_DelayMs(20);
+
+    // Disable interrupts for critical timing section (response + 40 bits, ~5ms)
+    __disable_irq();
 
     // MCU releases line (pull HIGH) and waits for response
     DHT11_PinWrite(1);
-    DHT11_DelayUs(40);
+    Timebase_DelayUs(40);
 
     // Switch to input mode
     DHT11_SetPinInput();
 
     // Wait for DHT11 to pull LOW (response signal)
-    timeout = 200;
-    while (DHT11_PinRead() && timeout--) {
-        DHT11_DelayUs(1);
-    }
-    if (timeout == 0) {
+    if (DHT11_WaitWhile(1) == 0) {
         __enable_irq();
         return DHT11_NO_ACK_0;
     }
 
     // DHT11 pulls LOW for ~80us
-    timeout = 200;
-    while (!DHT11_PinRead() && timeout--) {
-        DHT11_DelayUs(1);
-    }
-    if (timeout == 0) {
+    if (DHT11_WaitWhile(0) == 0) {
         __enable_irq();
         return DHT11_NO_ACK_1;
     }
 
     // DHT11 pulls HIGH for ~80us before data
-    timeout = 200;
-    while (DHT11_PinRead() && timeout--) {
-        DHT11_DelayUs(1);
-    }
-    if (timeout == 0) {
+    if (DHT11_WaitWhile(1) == 0) {
         __enable_irq();
         return DHT11_NO_ACK_0;
     }
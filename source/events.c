@@ -0,0 +1,96 @@
+#include <stddef.h>
+#include "MKL25Z4.h"
+#include "events.h"
+#include "timebase.h"
+
+#define EVENT_QUEUE_MASK    (EVENT_QUEUE_SIZE - 1U)
+
+typedef struct {
+    QueuedEvent_t slots[EVENT_QUEUE_SIZE];
+    volatile uint32_t head;     // Free-running, written by the producer only
+    volatile uint32_t tail;     // Free-running, written by the consumer only
+    volatile uint32_t overflows;
+    volatile uint8_t highWater;
+} EventQueue_t;
+
+static EventQueue_t queues[EVENT_SRC_COUNT];
+
+bool Events_Post(EventSource_t source, CarEvent_t event, uint16_t arg)
+{
+    return Events_PostAt(source, event, arg, Timebase_GetUs());
+}
+
+bool Events_PostAt(EventSource_t source, CarEvent_t event, uint16_t arg, uint32_t originUs)
+{
+    EventQueue_t *q = &queues[source];
+    uint32_t head = q->head;
+    uint32_t used = head - q->tail;
+    
+    if (used >= EVENT_QUEUE_SIZE) {
+        q->overflows++;
+        return false;
+    }
+    
+    QueuedEvent_t *slot = &q->slots[head & EVENT_QUEUE_MASK];
+    slot->event = (uint8_t)event;
+    slot->source = (uint8_t)source;
+    slot->arg = arg;
+    slot->timeUs = Timebase_GetUs();
+    slot->originUs = originUs;
+    
+    __DMB();  // Slot contents visible before the new head
+    q->head = head + 1U;
+    
+    if (used + 1U > q->highWater) {
+        q->highWater = (uint8_t)(used + 1U);
+    }
+    return true;
+}
+
+bool Events_Get(QueuedEvent_t *out)
+{
+    EventQueue_t *oldest = NULL;
+    const QueuedEvent_t *oldestSlot = NULL;
+    
+    // Sources are checked in priority order, so ties keep ISR events first
+    for (uint32_t i = 0; i < EVENT_SRC_COUNT; i++) {
+        EventQueue_t *q = &queues[i];
+        
+        if (q->head == q->tail) {
+            continue;
+        }
+        const QueuedEvent_t *slot = &q->slots[q->tail & EVENT_QUEUE_MASK];
+        if (oldestSlot == NULL || (int32_t)(slot->timeUs - oldestSlot->timeUs) < 0) {
+            oldest = q;
+            oldestSlot = slot;
+        }
+    }
+    
+    if (oldest == NULL) {
+        return false;
+    }
+    
+    __DMB();  // Read the slot (after seeing head) before releasing it
+    *out = *oldestSlot;
+    __DMB();
+    oldest->tail++;
+    return true;
+}
+
+bool Events_Pending(void)
+{
+    for (uint32_t i = 0; i < EVENT_SRC_COUNT; i++) {
+        if (queues[i].head != queues[i].tail) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Events_GetStats(EventStats_t *stats)
+{
+    for (uint32_t i = 0; i < EVENT_SRC_COUNT; i++) {
+        stats->overflows[i] = queues[i].overflows;
+        stats->highWater[i] = queues[i].highWater;
+    }
+}
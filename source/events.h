@@ -0,0 +1,78 @@
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "car_fsm.h"
+
+/**
+ * FSM Event Queues
+ * 
+ * One lock-free single-producer/single-consumer ring per event source,
+ * so an ISR never has to mask interrupts to post and never races another
+ * producer. The FSM (main loop) is the only consumer and merges the
+ * queues oldest-first by timestamp; on equal timestamps ISR sources come
+ * before the main loop.
+ * 
+ * Sensors do not post: the ranging DMA publishes a snapshot
+ * (Ultrasonic_GetSnapshot) and the obstacle task posts EVENT_OBSTACLE
+ * from the main loop after filtering it.
+ * 
+ * A full queue drops the new event and counts it (overflow), it never
+ * overwrites queued ones.
+ */
+
+#define EVENT_QUEUE_SIZE    16U     // Per source, power of two
+
+typedef enum {
+    EVENT_SRC_UART = 0,     // UART0 ISR (STOP fast path)
+    EVENT_SRC_TIMER,        // Software timer callbacks (TPM2 ISR)
+    EVENT_SRC_MAIN,         // Main loop (commands, obstacle checks)
+    EVENT_SRC_COUNT
+} EventSource_t;
+
+typedef struct {
+    uint8_t event;      // CarEvent_t
+    uint8_t source;     // EventSource_t
+    uint16_t arg;       // Event specific (e.g. distance in cm)
+    uint32_t timeUs;    // Timebase_GetUs() when posted (queue order)
+    uint32_t originUs;  // When it happened: command byte arrival, else timeUs
+} QueuedEvent_t;
+
+typedef struct {
+    uint32_t overflows[EVENT_SRC_COUNT];    // Events dropped (queue full)
+    uint8_t highWater[EVENT_SRC_COUNT];     // Most events ever queued at once
+} EventStats_t;
+
+/**
+ * @brief Post an event (each source must only post from one context)
+ * @return false if the queue was full and the event was dropped
+ */
+bool Events_Post(EventSource_t source, CarEvent_t event, uint16_t arg);
+
+/**
+ * @brief Post an event that happened earlier (e.g. a command at byte arrival)
+ * @param originUs Timebase_GetUs() when it happened, carried to the FSM for
+ *                 latency tracing. Ordering still uses the post time, so an
+ *                 ISR event posted first is never overtaken.
+ * @return false if the queue was full and the event was dropped
+ */
+bool Events_PostAt(EventSource_t source, CarEvent_t event, uint16_t arg, uint32_t originUs);
+
+/**
+ * @brief Take the oldest queued event across all sources
+ * @return false if every queue is empty
+ */
+bool Events_Get(QueuedEvent_t *out);
+
+/**
+ * @brief true if any queue holds an event (used before sleeping)
+ */
+bool Events_Pending(void);
+
+/**
+ * @brief Overflow and high-water counters
+ */
+void Events_GetStats(EventStats_t *stats);
+
+#endif // EVENTS_H
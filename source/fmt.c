@@ -0,0 +1,95 @@
+#include "fmt.h"
+
+/**
+ * Digit-pair formatting
+ * 
+ * digitPairs[2*k], digitPairs[2*k+1] are the two ASCII digits of k (0-99),
+ * so each step peels off two digits with one Fmt_Div100().
+ */
+static const char digitPairs[200] = {
+    '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+    '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+    '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+    '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+    '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+    '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+    '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+    '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+    '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+    '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9'
+};
+
+static const char hexDigits[16] = {
+    '0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F'
+};
+
+uint8_t Fmt_U32(char *buf, uint32_t value)
+{
+    char tmp[FMT_U32_MAX_LEN];
+    uint8_t i = FMT_U32_MAX_LEN;
+    uint8_t len;
+    
+    // Two digits per iteration, right to left
+    while (value >= 100U) {
+        uint32_t q = Fmt_Div100(value);
+        uint32_t r = value - q * 100U;
+        
+        tmp[--i] = digitPairs[2U * r + 1U];
+        tmp[--i] = digitPairs[2U * r];
+        value = q;
+    }
+    
+    // 0-99 left
+    if (value >= 10U) {
+        tmp[--i] = digitPairs[2U * value + 1U];
+        tmp[--i] = digitPairs[2U * value];
+    } else {
+        tmp[--i] = (char)('0' + value);
+    }
+    
+    len = FMT_U32_MAX_LEN - i;
+    for (uint8_t k = 0; k < len; k++) {
+        buf[k] = tmp[i + k];
+    }
+    return len;
+}
+
+uint8_t Fmt_I32(char *buf, int32_t value)
+{
+    if (value < 0) {
+        buf[0] = '-';
+        // Negate in unsigned arithmetic so INT32_MIN works too
+        return 1U + Fmt_U32(buf + 1, 0U - (uint32_t)value);
+    }
+    return Fmt_U32(buf, (uint32_t)value);
+}
+
+uint8_t Fmt_Centi(char *buf, uint32_t centi)
+{
+    uint32_t whole = Fmt_Div100(centi);
+    uint32_t frac = centi - whole * 100U;
+    uint8_t len = Fmt_U32(buf, whole);
+    
+    buf[len++] = '.';
+    buf[len++] = digitPairs[2U * frac];
+    buf[len++] = digitPairs[2U * frac + 1U];
+    return len;
+}
+
+uint8_t Fmt_Hex32(char *buf, uint32_t value, uint8_t minDigits)
+{
+    uint8_t digits = FMT_HEX32_MAX_LEN;
+    
+    if (minDigits < 1U) minDigits = 1U;
+    if (minDigits > FMT_HEX32_MAX_LEN) minDigits = FMT_HEX32_MAX_LEN;
+    
+    // Skip leading zero nibbles down to minDigits
+    while (digits > minDigits && (value >> (4U * (digits - 1U))) == 0U) {
+        digits--;
+    }
+    
+    for (uint8_t k = 0; k < digits; k++) {
+        buf[k] = hexDigits[(value >> (4U * (digits - 1U - k))) & 0xFU];
+    }
+    return digits;
+}
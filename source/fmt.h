@@ -0,0 +1,57 @@
+#ifndef FMT_H
+#define FMT_H
+
+#include <stdint.h>
+
+/**
+ * Division-free Integer Formatting
+ * 
+ * The Cortex-M0+ has no divide instruction, so every '/' or '%' is a call
+ * into the software divide routine. These helpers replace the per-digit
+ * "% 10, / 10" loop with reciprocal multiplication and a digit-pair table
+ * (two digits per step, no division at all).
+ * 
+ * All functions write into buf (not NUL-terminated) and return the number
+ * of characters written.
+ */
+
+#define FMT_U32_MAX_LEN     10U     // "4294967295"
+#define FMT_I32_MAX_LEN     11U     // "-2147483648"
+#define FMT_CENTI_MAX_LEN   11U     // "42949672.95"
+#define FMT_HEX32_MAX_LEN   8U      // "FFFFFFFF"
+
+/**
+ * @brief n / 100 without a divide instruction
+ * Uses a 32-bit multiply while exact (n < 43699), 32x32->64 otherwise.
+ */
+static inline uint32_t Fmt_Div100(uint32_t n)
+{
+    if (n < 43699U) {
+        return (n * 5243U) >> 19;
+    }
+    return (uint32_t)(((uint64_t)n * 0x51EB851FU) >> 37);
+}
+
+/**
+ * @brief Format unsigned decimal
+ */
+uint8_t Fmt_U32(char *buf, uint32_t value);
+
+/**
+ * @brief Format signed decimal (leading '-' for negatives)
+ */
+uint8_t Fmt_I32(char *buf, int32_t value);
+
+/**
+ * @brief Format a centi-unit fixed-point value, e.g. 2305 -> "23.05"
+ * Matches the DHT11 driver output (temperature/humidity x 100)
+ */
+uint8_t Fmt_Centi(char *buf, uint32_t centi);
+
+/**
+ * @brief Format uppercase hex without prefix
+ * @param minDigits Zero-pad to at least this many digits (1-8)
+ */
+uint8_t Fmt_Hex32(char *buf, uint32_t value, uint8_t minDigits);
+
+#endif // FMT_H
@@ -0,0 +1,74 @@
+#include "log.h"
+
+#if LOG_BACKEND == LOG_BACKEND_UART1
+
+#include "fsl_uart.h"
+#include "fsl_port.h"
+#include "fsl_clock.h"
+#include "fmt.h"
+
+/**
+ * Log backend on UART1
+ * 
+ * TX only: PTE0 = UART1_TX (Alt3). Connect a USB-serial adapter RX to PTE0.
+ * UART1 runs from the bus clock, so 115200 baud is exact enough and a
+ * debug line costs ~4ms instead of ~45ms at 9600.
+ */
+#define LOG_UART            UART1
+#define LOG_UART_BAUDRATE   115200U
+#define LOG_TX_PORT         PORTE
+#define LOG_TX_PIN          0U      // PTE0 = UART1_TX
+
+void Log_Init(void)
+{
+    uart_config_t config;
+    
+    CLOCK_EnableClock(kCLOCK_PortE);
+    PORT_SetPinMux(LOG_TX_PORT, LOG_TX_PIN, kPORT_MuxAlt3);
+    
+    UART_GetDefaultConfig(&config);
+    config.baudRate_Bps = LOG_UART_BAUDRATE;
+    config.enableTx = true;
+    config.enableRx = false;
+    UART_Init(LOG_UART, &config, CLOCK_GetBusClkFreq());
+    
+    Log_String("\r\n[LOG] UART1 log started\r\n");
+}
+
+void Log_String(const char *str)
+{
+    const char *end = str;
+    
+    while (*end) {
+        end++;
+    }
+    UART_WriteBlocking(LOG_UART, (const uint8_t *)str, (size_t)(end - str));
+}
+
+void Log_Number(uint32_t num)
+{
+    char buffer[FMT_U32_MAX_LEN];
+    uint8_t len = Fmt_U32(buffer, num);
+    
+    UART_WriteBlocking(LOG_UART, (const uint8_t *)buffer, len);
+}
+
+#elif LOG_BACKEND == LOG_BACKEND_BLUETOOTH
+
+#include "uart.h"
+
+void Log_Init(void)
+{
+}
+
+void Log_String(const char *str)
+{
+    UART_SendString(str);
+}
+
+void Log_Number(uint32_t num)
+{
+    UART_SendNumber(num);
+}
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdint.h>
+
+/**
+ * Debug Log Backend
+ * 
+ * Diagnostics (e.g. the [PWM]/[FW] lines in motor.c) are kept off the
+ * 9600-baud HC-05 link so it only carries protocol traffic.
+ * 
+ * LOG_BACKEND selects where they go:
+ *   LOG_BACKEND_NONE      - compiled out completely
+ *   LOG_BACKEND_UART1     - UART1 TX on PTE0 (J2), 115200 baud, via fsl_uart
+ *   LOG_BACKEND_BLUETOOTH - old behaviour, shares UART0 with Bluetooth
+ */
+#define LOG_BACKEND_NONE        0
+#define LOG_BACKEND_UART1       1
+#define LOG_BACKEND_BLUETOOTH   2
+
+#ifndef LOG_BACKEND
+#define LOG_BACKEND             LOG_BACKEND_UART1
+#endif
+
+#if LOG_BACKEND == LOG_BACKEND_NONE
+
+#define Log_Init()          ((void)0)
+#define Log_String(str)     ((void)(str))
+#define Log_Number(num)     ((void)(num))
+
+#else
+
+/**
+ * @brief Initialize the log backend (UART1 pins and baud rate)
+ */
+void Log_Init(void);
+
+/**
+ * @brief Write a string to the log
+ */
+void Log_String(const char *str);
+
+/**
+ * @brief Write an unsigned number to the log
+ */
+void Log_Number(uint32_t num);
+
+#endif
+
+#endif // LOG_H
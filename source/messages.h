@@ -0,0 +1,65 @@
+#ifndef MESSAGES_H
+#define MESSAGES_H
+
+/**
+ * Telemetry Message Table (shared with the host decoder)
+ * 
+ * Every runtime message sent to the phone is listed once here. msg.c
+ * expands the text on the target (verbose mode) or sends only the id and
+ * the arguments (compact mode); tools/msg_decode.cpp includes this same
+ * file to turn the compact stream back into text.
+ * 
+ * Placeholders:
+ *   %u  unsigned number        (compact: varint)
+ *   %c  centi value "whole.ff" (compact: varint of value x 100)
+ *   %s  string                 (compact: varint length + bytes)
+ *   %%  literal '%'
+ * 
+ * Compact wire format: (MSG_WIRE_BASE + id) followed by the arguments,
+ * varints are LEB128 (7 bits per byte, low group first). Bytes below
+ * MSG_WIRE_BASE are plain text (boot banner, init messages).
+ * 
+ * Only append new messages: the position is the wire id.
+ * Plain C, no target headers - must stay includable from host C++.
+ */
+
+#define MSG_WIRE_BASE   0x80U
+
+#define MESSAGE_LIST(X) \
+    X(MSG_STATE_IDLE,       ">> State: IDLE\r\n")                           \
+    X(MSG_STATE_FORWARD,    ">> State: FORWARD\r\n")                        \
+    X(MSG_STATE_BACKWARD,   ">> State: BACKWARD\r\n")                       \
+    X(MSG_PIVOT_LEFT,       ">> Pivot LEFT 90deg...\r\n")                   \
+    X(MSG_PIVOT_RIGHT,      ">> Pivot RIGHT 90deg...\r\n")                  \
+    X(MSG_TURN_COMPLETE,    ">> Turn complete -> IDLE\r\n")                 \
+    X(MSG_OBSTACLE_FRONT,   "!! OBSTACLE at %u cm - STOPPED !!\r\n")        \
+    X(MSG_OBSTACLE_REAR,    "!! REAR OBSTACLE at %u cm - STOPPED !!\r\n")   \
+    X(MSG_LIGHTS_ON,        ">> Lights ON\r\n")                             \
+    X(MSG_LIGHTS_OFF,       ">> Lights OFF\r\n")                            \
+    X(MSG_AUTO_LIGHTS_ON,   ">> Auto-lights ON\r\n")                        \
+    X(MSG_AUTO_LIGHTS_OFF,  ">> Auto-lights OFF\r\n")                       \
+    X(MSG_SPEED,            "Speed: %u%%\r\n")                              \
+    X(MSG_UNKNOWN_COMMAND,  "? Unknown command\r\n")                        \
+    X(MSG_VERBOSE_ON,       ">> Messages: verbose\r\n")                     \
+    X(MSG_COMPACT_ON,       ">> Messages: compact\r\n")                     \
+    X(MSG_INFO_HEADER,      "=== Sensor Info ===\r\n")                      \
+    X(MSG_INFO_STATE,       "State: %s\r\n")                                \
+    X(MSG_INFO_DISTANCE,    "FRONT: %u cm\r\nREAR: %u cm\r\n")              \
+    X(MSG_INFO_LIGHT,       "Light: %u (ADC)\r\n")                          \
+    X(MSG_INFO_CLIMATE,     "Temp: %c C\r\nHumidity: %u%%\r\n")             \
+    X(MSG_INFO_DHT11_ERROR, "DHT11: Error - %s\r\n")                        \
+    X(MSG_INFO_ESTOP,       "E-stops: %u (worst %u us)\r\n")                \
+    X(MSG_INFO_FOOTER,      "==================\r\n")                     \
+    X(MSG_INFO_EVENTS,      "Events: max %u queued, %u lost\r\n")          \
+    X(MSG_INFO_TASK,        "Task %s: %u runs, %u overruns, max %u ms\r\n") \
+    X(MSG_INFO_POWER,       "Power: run %u ms, wait %u ms, vlps %u ms\r\n") \
+    X(MSG_INFO_CMD_LATENCY, "Cmd latency: p50 %u us, p99 %u us, max %u us\r\n")
+
+typedef enum {
+#define MESSAGE_ENUM_ENTRY(id, text)  id,
+    MESSAGE_LIST(MESSAGE_ENUM_ENTRY)
+#undef MESSAGE_ENUM_ENTRY
+    MSG_COUNT
+} MsgId_t;
+
+#endif // MESSAGES_H
@@ -0,0 +1,147 @@
+#include "motion.h"
+
+// Limits, percent duty per second (and per second squared for jerk)
+#define MOTION_ACCEL_PCT_S      400U    // Speeding up: 25% -> 100% in ~240ms
+#define MOTION_DECEL_PCT_S      800U    // Slowing down: 100% -> 0 in ~170ms
+#define MOTION_JERK_PCT_S2      8000U   // 0 -> full acceleration in 50ms
+#define MOTION_DEAD_TIME_MS     20U     // Coast between reversing directions
+#define MOTION_START_DUTY       25U     // Deadband: motors stall below this
+
+// Per-tick steps in percent Q16
+#define ACCEL_STEP      ((int32_t)((MOTION_ACCEL_PCT_S * 65536U) / MOTION_TICK_HZ))
+#define DECEL_STEP      ((int32_t)((MOTION_DECEL_PCT_S * 65536U) / MOTION_TICK_HZ))
+#define JERK_STEP       ((int32_t)((MOTION_JERK_PCT_S2 * 65536ULL) / (MOTION_TICK_HZ * MOTION_TICK_HZ)))
+#define DEAD_TICKS      ((uint8_t)((MOTION_DEAD_TIME_MS * MOTION_TICK_HZ) / 1000U))
+#define START_DUTY      MOTION_Q16(MOTION_START_DUTY)
+
+// Largest |delta| whose unwind test still fits in 32 bits
+#define UNWIND_DELTA_MAX    (0xFFFFFFFFU / (2U * (uint32_t)JERK_STEP))
+
+static inline int32_t Motion_Sign(int32_t value)
+{
+    return (value > 0) - (value < 0);
+}
+
+static inline int32_t Motion_Abs(int32_t value)
+{
+    return (value < 0) ? -value : value;
+}
+
+void Motion_Reset(MotionAxis_t *axis)
+{
+    axis->duty = 0;
+    axis->accel = 0;
+    axis->target = 0;
+    axis->dir = 0;
+    axis->deadTicks = 0;
+}
+
+void Motion_SetTarget(MotionAxis_t *axis, int16_t percent)
+{
+    if (percent > 100) percent = 100;
+    if (percent < -100) percent = -100;
+    axis->target = MOTION_Q16(percent);
+}
+
+/**
+ * @brief One jerk-limited step of duty towards goal (same sign as duty, or 0)
+ *
+ * Acceleration grows by JERK_STEP per tick up to the limit, and starts
+ * shrinking once the duty still to go is what unwinding it will cover
+ * (|a|^2 / 2j + |a| / 2), so the duty lands on the goal with a ~ 0.
+ */
+static void Motion_Ramp(MotionAxis_t *axis, int32_t goal)
+{
+    int32_t delta = goal - axis->duty;
+    int32_t sign = Motion_Sign(delta);
+    int32_t a = axis->accel;
+    int32_t limit = (Motion_Sign(axis->duty) == -sign) ? DECEL_STEP : ACCEL_STEP;
+    int32_t absA = Motion_Abs(a);
+
+    uint32_t absDelta = (uint32_t)Motion_Abs(delta);
+
+    // Unwinding distance, compared without a divide (no hardware divide);
+    // |a| is at most DECEL_STEP, so the left side always fits in 32 bits
+    bool unwind = (a * sign > 0) && (absDelta <= UNWIND_DELTA_MAX) &&
+        ((uint32_t)absA * (uint32_t)(absA + JERK_STEP) >= absDelta * (uint32_t)(2 * JERK_STEP));
+
+    if (unwind) {
+        a -= sign * JERK_STEP;
+        if (a * sign < 0) {
+            a = 0;
+        }
+    } else {
+        a += sign * JERK_STEP;
+        if (a * sign > limit) {
+            a = sign * limit;
+        }
+    }
+
+    int32_t before = axis->duty;
+    axis->duty += a;
+    axis->accel = a;
+
+    // Arrived (or would overshoot): settle exactly on the goal
+    if (Motion_Sign(goal - axis->duty) != sign) {
+        axis->duty = goal;
+        axis->accel = 0;
+    }
+    // Still braking from an older target: never carry through zero
+    if (Motion_Sign(axis->duty) == -Motion_Sign(before)) {
+        axis->duty = 0;
+        axis->accel = 0;
+    }
+}
+
+bool Motion_Step(MotionAxis_t *axis)
+{
+    if (axis->deadTicks > 0) {
+        axis->deadTicks--;
+        return false;
+    }
+
+    int32_t target = axis->target;
+
+    if (axis->duty == 0) {
+        int8_t dir = (int8_t)Motion_Sign(target);
+
+        if (dir == 0) {
+            return false;  // Coasting and nothing requested
+        }
+        // Start: jump over the deadband, then ramp from there
+        axis->dir = dir;
+        axis->duty = (Motion_Abs(target) < START_DUTY) ? target : dir * START_DUTY;
+        axis->accel = 0;
+        return true;
+    }
+
+    // Reversal: ramp to zero first
+    int32_t goal = (Motion_Sign(target) == Motion_Sign(axis->duty)) ? target : 0;
+
+    if (axis->duty != goal || axis->accel != 0) {
+        Motion_Ramp(axis, goal);
+    }
+
+    // Inside the deadband on the way down the motor has stopped already
+    if (goal == 0 && Motion_Abs(axis->duty) < START_DUTY) {
+        axis->duty = 0;
+        axis->accel = 0;
+    }
+
+    if (axis->duty == 0) {
+        // Only a reversal coasts first: a stop, or a later start from
+        // standstill, has nothing on the bridge to wait for
+        if (Motion_Sign(target) == -axis->dir) {
+            axis->deadTicks = DEAD_TICKS;
+        }
+        axis->dir = 0;
+        return true;
+    }
+    return false;
+}
+
+bool Motion_Settled(const MotionAxis_t *axis)
+{
+    return axis->duty == axis->target && axis->accel == 0 && axis->deadTicks == 0 &&
+           axis->dir == Motion_Sign(axis->target);
+}
@@ -0,0 +1,68 @@
+#ifndef MOTION_H
+#define MOTION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Motion Profiles (per-wheel speed ramps, no hardware access)
+ *
+ * Every tick (TPM0 overflow, 1ms) each wheel moves its duty towards the
+ * target with limited acceleration and jerk, so the duty follows an
+ * S-curve instead of a step: no inrush spike from a stalled motor, no
+ * wheel slip, no supply dip that browns out the board.
+ *
+ * Direction reversal goes through zero: the wheel ramps down, coasts for
+ * MOTION_DEAD_TIME_MS with both bridge inputs low, then ramps up the
+ * other way. A start from standstill skips the dead time. Below
+ * MOTION_START_DUTY the motors do not turn at all, so a start jumps
+ * straight to it and a stop drops to 0 from it - short bursts move the
+ * car right away instead of spending the ramp in the deadband.
+ *
+ * Duties are signed percent in Q16 (+ forward, - backward). Limits are
+ * set at the top of motion.c. Plain C so tools/ can run the same profile
+ * on the PC.
+ */
+
+#define MOTION_TICK_HZ      1000U
+#define MOTION_Q16(pct)     ((int32_t)(pct) * 65536)
+
+typedef struct {
+    int32_t duty;       // Current duty, percent Q16 (signed)
+    int32_t accel;      // Duty change per tick, percent Q16
+    int32_t target;     // Requested duty, percent Q16 (signed)
+    int8_t dir;         // Direction on the bridge inputs: +1, -1, 0 = coast
+    uint8_t deadTicks;  // Coast ticks left before the next start
+} MotionAxis_t;
+
+/**
+ * @brief Stopped and coasting, no dead time (also used for emergency stop)
+ */
+void Motion_Reset(MotionAxis_t *axis);
+
+/**
+ * @brief Request a new duty, -100..100 percent (applied from the next tick)
+ */
+void Motion_SetTarget(MotionAxis_t *axis, int16_t percent);
+
+/**
+ * @brief Advance one tick
+ * @return true if axis->dir changed (bridge inputs must be rewritten)
+ */
+bool Motion_Step(MotionAxis_t *axis);
+
+/**
+ * @brief true once the axis sits at its target with no ramp or dead time left
+ */
+bool Motion_Settled(const MotionAxis_t *axis);
+
+/**
+ * @brief |duty| in percent Q8 (0..25600), for the PWM scaling
+ */
+static inline uint32_t Motion_DutyQ8(const MotionAxis_t *axis)
+{
+    int32_t duty = axis->duty;
+    return (uint32_t)((duty < 0) ? -duty : duty) >> 8;
+}
+
+#endif // MOTION_H
@@ -3,8 +3,12 @@
 #include "fsl_port.h"
 #include "fsl_tpm.h"
 #include "fsl_clock.h"
+#include "fsl_common.h"
 #include "MKL25Z4.h"
 #include "uart.h"
+#include "log.h"
+#include "prof.h"
+#include "motion.h"
 
 /**
  * Motor Control using L293D Dual H-Bridge Driver
@@ -25,6 +29,11 @@
  *   IN1=0, IN2=1 -> Backward
  *   IN1=0, IN2=0 -> Stop (coast)
  *   IN1=1, IN2=1 -> Stop (brake)
+ * 
+ * Motor_Forward/Backward/TurnLeft/TurnRight/Stop only set a signed target
+ * per wheel. The TPM0 overflow interrupt (once per PWM period) steps the
+ * motion profiles (motion.h), writes CnV and the direction pins, and
+ * turns itself off once both wheels have settled.
  */
 
 // Motor Left pins
@@ -50,8 +59,37 @@
 // PWM Configuration
 #define PWM_FREQUENCY       1000U   // 1kHz PWM frequency
 
+// MOTOR_STOP_BRAKE_COAST: shorted-motor braking time before coasting
+// (ms = PWM periods; long enough to stop from full speed)
+#define MOTOR_BRAKE_TIME_MS 300U
+
 static uint8_t defaultSpeed = 100;   // Default speed 100%
 
+// PWM counts per 1% duty in Q16 (MOD * 65536 / 100), computed once at init
+// so Motor_DutyCounts() needs a multiply instead of a software divide
+static uint32_t pwmCountsPerPercentQ16 = 0;
+
+// Set by Motor_EmergencyStop() (UART0 ISR); PWM stays off until the STOP
+// command itself has been through the FSM (Task_Commands calls
+// Motor_ReleaseEmergencyStop())
+static volatile bool emergencyStopped = false;
+
+// Command latency trace armed by the FSM (main loop only), handed to the
+// TPM0 ISR with the new targets
+static bool traceArmed = false;
+static uint32_t traceArrivalUs = 0;
+static volatile bool traceIsrPending = false;
+static uint32_t traceIsrArrivalUs = 0;
+
+// Per-wheel motion profiles (TPM0 ISR; targets set with interrupts masked)
+static MotionAxis_t leftAxis;
+static MotionAxis_t rightAxis;
+
+// Active brake (Motor_StopWith): the profiles are frozen while it holds.
+// brakeTicks counts down to the release, 0 = hold until the next command.
+static volatile bool braking = false;
+static volatile uint16_t brakeTicks = 0;
+
 // Compensare pentru motorul drept care e mai lent
 #define RIGHT_MOTOR_BOOST  0 // +50% pentru motorul drept
 
@@ -100,34 +138,146 @@ static void Motor_InitPWM(void)
     
     // Set MOD for 1kHz PWM (tpmClock / prescale / frequency)
     TPM0->MOD = (tpmClock / 4 / PWM_FREQUENCY) - 1;
+    pwmCountsPerPercentQ16 = (TPM0->MOD << 16) / 100U;
+    
+    Motion_Reset(&leftAxis);
+    Motion_Reset(&rightAxis);
     
-    // Start TPM0
+    // Start TPM0; the overflow interrupt runs the motion profiles
     TPM0->SC |= TPM_SC_CMOD(1);  // Use internal clock
+    NVIC_SetPriority(TPM0_IRQn, 1);  // Below the UART0 STOP fast path
+    NVIC_EnableIRQ(TPM0_IRQn);
     
     UART_SendString("  Motor_InitPWM() done\r\n");
 }
 
-static void Motor_SetBothPWM(uint8_t leftPercent, uint8_t rightPercent)
+/**
+ * @brief Drive one wheel's bridge inputs: +1 forward, -1 backward, 0 coast
+ */
+static void Motor_SetLeftDir(int8_t dir)
+{
+    MOTOR_L_IN1_GPIO->PCOR = (1U << MOTOR_L_IN1_PIN) | (1U << MOTOR_L_IN2_PIN);
+    if (dir > 0) {
+        MOTOR_L_IN1_GPIO->PSOR = 1U << MOTOR_L_IN1_PIN;
+    } else if (dir < 0) {
+        MOTOR_L_IN2_GPIO->PSOR = 1U << MOTOR_L_IN2_PIN;
+    }
+}
+
+static void Motor_SetRightDir(int8_t dir)
+{
+    MOTOR_R_IN1_GPIO->PCOR = 1U << MOTOR_R_IN1_PIN;
+    MOTOR_R_IN2_GPIO->PCOR = 1U << MOTOR_R_IN2_PIN;
+    if (dir > 0) {
+        MOTOR_R_IN1_GPIO->PSOR = 1U << MOTOR_R_IN1_PIN;
+    } else if (dir < 0) {
+        MOTOR_R_IN2_GPIO->PSOR = 1U << MOTOR_R_IN2_PIN;
+    }
+}
+
+/**
+ * @brief Bridge inputs low and no PWM: both wheels roll out freely
+ * @note Interrupts masked
+ */
+static void Motor_Coast(void)
+{
+    Motor_SetLeftDir(0);
+    Motor_SetRightDir(0);
+    TPM0->CONTROLS[1].CnV = 0;
+    TPM0->CONTROLS[2].CnV = 0;
+    braking = false;
+}
+
+/**
+ * @brief Profile duty -> CnV counts (no divide: Q8 percent x Q8 counts/percent)
+ */
+static inline uint32_t Motor_DutyCounts(const MotionAxis_t *axis)
+{
+    return (Motion_DutyQ8(axis) * (pwmCountsPerPercentQ16 >> 8)) >> 16;
+}
+
+/**
+ * @brief TPM0 overflow: one motion profile step per PWM period
+ * 
+ * Runs with interrupts masked (a few us) so the UART0 STOP fast path can
+ * never land between the emergency check and the CnV / pin writes.
+ * CnV written here is latched at the next overflow.
+ */
+void TPM0_IRQHandler(void)
+{
+    uint32_t primask = DisableGlobalIRQ();
+    
+    TPM0->SC |= TPM_SC_TOF_MASK;  // Write 1 to clear
+    
+    if (braking) {
+        uint16_t ticks = brakeTicks;
+        if (ticks > 0) {
+            brakeTicks = --ticks;
+            if (ticks == 0) {
+                Motor_Coast();  // MOTOR_STOP_BRAKE_COAST: brake time is over
+            }
+        }
+    } else if (!emergencyStopped) {
+        if (Motion_Step(&leftAxis)) {
+            Motor_SetLeftDir(leftAxis.dir);
+        }
+        if (Motion_Step(&rightAxis)) {
+            Motor_SetRightDir(rightAxis.dir);
+        }
+        
+        // SWAPPED: Hardware wiring has channels reversed
+        TPM0->CONTROLS[1].CnV = Motor_DutyCounts(&rightAxis);  // TPM0_CH1 (PTA4) = Motor Right
+        TPM0->CONTROLS[2].CnV = Motor_DutyCounts(&leftAxis);   // TPM0_CH2 (PTA5) = Motor Left
+        
+        // First PWM write after a traced command closes the trace
+        if (traceIsrPending) {
+            traceIsrPending = false;
+            Prof_Record(PROF_CMD_LATENCY, Timebase_ElapsedUs(traceIsrArrivalUs));
+        }
+    }
+    
+    bool idle = braking ? (brakeTicks == 0) : (Motion_Settled(&leftAxis) && Motion_Settled(&rightAxis));
+    if (emergencyStopped || idle) {
+        TPM0->SC &= ~TPM_SC_TOIE_MASK;  // Nothing left to ramp or time
+    }
+    
+    EnableGlobalIRQ(primask);
+}
+
+/**
+ * @brief New signed targets (percent, + forward) for the motion profiles
+ */
+static void Motor_SetTargets(int16_t leftPercent, int16_t rightPercent)
 {
-    if (leftPercent > 100) leftPercent = 100;
-    if (rightPercent > 100) rightPercent = 100;
-    
-    uint32_t mod = TPM0->MOD;
-    uint32_t leftDuty = (mod * leftPercent) / 100;
-    uint32_t rightDuty = (mod * rightPercent) / 100;
-    
-    // Debug: print actual values
-    UART_SendString("[PWM] MOD=");
-    UART_SendNumber(mod);
-    UART_SendString(" L_duty=");
-    UART_SendNumber(leftDuty);
-    UART_SendString(" R_duty=");
-    UART_SendNumber(rightDuty);
-    UART_SendString("\r\n");
-    
-    // SWAPPED: Hardware wiring has channels reversed
-    TPM0->CONTROLS[1].CnV = rightDuty;  // TPM0_CH1 (PTA4) = Motor Right
-    TPM0->CONTROLS[2].CnV = leftDuty;   // TPM0_CH2 (PTA5) = Motor Left
+    // Debug: print requested values
+    Log_String("[PWM] L_target=");
+    Log_String((leftPercent < 0) ? "-" : "");
+    Log_Number((uint32_t)((leftPercent < 0) ? -leftPercent : leftPercent));
+    Log_String(" R_target=");
+    Log_String((rightPercent < 0) ? "-" : "");
+    Log_Number((uint32_t)((rightPercent < 0) ? -rightPercent : rightPercent));
+    Log_String("\r\n");
+    
+    // A stale command finishing after an ISR emergency stop must not restart the motors
+    uint32_t primask = DisableGlobalIRQ();
+    if (braking && leftPercent == 0 && rightPercent == 0) {
+        // Already stopping harder than a ramp would: keep the brake
+    } else if (!emergencyStopped) {
+        if (braking) {
+            // Release the brake; the profiles start from standstill, no dead time
+            Motor_Coast();
+        }
+        Motion_SetTarget(&leftAxis, leftPercent);
+        Motion_SetTarget(&rightAxis, rightPercent);
+        
+        if (traceArmed) {
+            traceArmed = false;
+            traceIsrArrivalUs = traceArrivalUs;
+            traceIsrPending = true;
+        }
+        TPM0->SC = (TPM0->SC & ~TPM_SC_TOF_MASK) | TPM_SC_TOIE_MASK;  // Leave TOF alone
+    }
+    EnableGlobalIRQ(primask);
 }
 
 void Motor_Init(void)
@@ -175,101 +325,138 @@ void Motor_Init(void)
 
 void Motor_Forward(uint8_t speed)
 {
-    // Set directions: both motors FORWARD
-    // Left: IN1=1, IN2=0 → Forward
-    // Right: IN1=1, IN2=0 → Forward
-    GPIO_WritePinOutput(MOTOR_L_IN1_GPIO, MOTOR_L_IN1_PIN, 1);
-    GPIO_WritePinOutput(MOTOR_L_IN2_GPIO, MOTOR_L_IN2_PIN, 0);
-    GPIO_WritePinOutput(MOTOR_R_IN1_GPIO, MOTOR_R_IN1_PIN, 1);
-    GPIO_WritePinOutput(MOTOR_R_IN2_GPIO, MOTOR_R_IN2_PIN, 0);
+    // Both motors FORWARD (IN1=1, IN2=0), set by the TPM0 ISR once any
+    // reversal has ramped through zero
     
     // Compensate right motor (it's slower)
     uint8_t leftSpeed = (speed > RIGHT_MOTOR_BOOST) ? (speed - RIGHT_MOTOR_BOOST) : 0;
     
-    UART_SendString("[FW] L=");
-    UART_SendNumber(leftSpeed);
-    UART_SendString(" R=");
-    UART_SendNumber(speed);
-    UART_SendString("\r\n");
+    Log_String("[FW] L=");
+    Log_Number(leftSpeed);
+    Log_String(" R=");
+    Log_Number(speed);
+    Log_String("\r\n");
     
-    Motor_SetBothPWM(leftSpeed, speed);
+    Motor_SetTargets(leftSpeed, speed);
 }
 
 void Motor_Backward(uint8_t speed)
 {
-    // Set directions: both motors BACKWARD
-    // Left: IN1=0, IN2=1 → Backward
-    // Right: IN1=0, IN2=1 → Backward
-    GPIO_WritePinOutput(MOTOR_L_IN1_GPIO, MOTOR_L_IN1_PIN, 0);
-    GPIO_WritePinOutput(MOTOR_L_IN2_GPIO, MOTOR_L_IN2_PIN, 1);
-    GPIO_WritePinOutput(MOTOR_R_IN1_GPIO, MOTOR_R_IN1_PIN, 0);
-    GPIO_WritePinOutput(MOTOR_R_IN2_GPIO, MOTOR_R_IN2_PIN, 1);
+    // Both motors BACKWARD (IN1=0, IN2=1)
     
     uint8_t leftSpeed = (speed > RIGHT_MOTOR_BOOST) ? (speed - RIGHT_MOTOR_BOOST) : 0;
     
-    UART_SendString("[BW] L=");
-    UART_SendNumber(leftSpeed);
-    UART_SendString(" R=");
-    UART_SendNumber(speed);
-    UART_SendString("\r\n");
+    Log_String("[BW] L=");
+    Log_Number(leftSpeed);
+    Log_String(" R=");
+    Log_Number(speed);
+    Log_String("\r\n");
     
-    Motor_SetBothPWM(leftSpeed, speed);
+    Motor_SetTargets(-(int16_t)leftSpeed, -(int16_t)speed);
 }
 
 void Motor_TurnLeft(uint8_t speed)
 {
     // Pivot turn LEFT: left motor BACKWARD, right motor FORWARD
-    // Left: IN1=0, IN2=1 → Backward
-    // Right: IN1=1, IN2=0 → Forward
-    GPIO_WritePinOutput(MOTOR_L_IN1_GPIO, MOTOR_L_IN1_PIN, 0);
-    GPIO_WritePinOutput(MOTOR_L_IN2_GPIO, MOTOR_L_IN2_PIN, 1);
-    GPIO_WritePinOutput(MOTOR_R_IN1_GPIO, MOTOR_R_IN1_PIN, 1);
-    GPIO_WritePinOutput(MOTOR_R_IN2_GPIO, MOTOR_R_IN2_PIN, 0);
     
     uint8_t leftSpeed = (speed > RIGHT_MOTOR_BOOST) ? (speed - RIGHT_MOTOR_BOOST) : 0;
     
-    UART_SendString("[PIVOT LEFT] L=");
-    UART_SendNumber(leftSpeed);
-    UART_SendString(" R=");
-    UART_SendNumber(speed);
-    UART_SendString("\r\n");
+    Log_String("[PIVOT LEFT] L=");
+    Log_Number(leftSpeed);
+    Log_String(" R=");
+    Log_Number(speed);
+    Log_String("\r\n");
     
-    Motor_SetBothPWM(leftSpeed, speed);
+    Motor_SetTargets(-(int16_t)leftSpeed, speed);
 }
 
 void Motor_TurnRight(uint8_t speed)
 {
     // Pivot turn RIGHT: left motor FORWARD, right motor BACKWARD
-    // Left: IN1=1, IN2=0 → Forward
-    // Right: IN1=0, IN2=1 → Backward
-    GPIO_WritePinOutput(MOTOR_L_IN1_GPIO, MOTOR_L_IN1_PIN, 1);
-    GPIO_WritePinOutput(MOTOR_L_IN2_GPIO, MOTOR_L_IN2_PIN, 0);
-    GPIO_WritePinOutput(MOTOR_R_IN1_GPIO, MOTOR_R_IN1_PIN, 0);
-    GPIO_WritePinOutput(MOTOR_R_IN2_GPIO, MOTOR_R_IN2_PIN, 1);
     
     uint8_t leftSpeed = (speed > RIGHT_MOTOR_BOOST) ? (speed - RIGHT_MOTOR_BOOST) : 0;
     
-    UART_SendString("[PIVOT RIGHT] L=");
-    UART_SendNumber(leftSpeed);
-    UART_SendString(" R=");
-    UART_SendNumber(speed);
-    UART_SendString("\r\n");
+    Log_String("[PIVOT RIGHT] L=");
+    Log_Number(leftSpeed);
+    Log_String(" R=");
+    Log_Number(speed);
+    Log_String("\r\n");
     
-    Motor_SetBothPWM(leftSpeed, speed);
+    Motor_SetTargets(leftSpeed, -(int16_t)speed);
 }
 
 void Motor_Stop(void)
 {
-    // Set both motors to coast (IN1=0, IN2=0)
-    GPIO_WritePinOutput(MOTOR_L_IN1_GPIO, MOTOR_L_IN1_PIN, 0);
-    GPIO_WritePinOutput(MOTOR_L_IN2_GPIO, MOTOR_L_IN2_PIN, 0);
-    GPIO_WritePinOutput(MOTOR_R_IN1_GPIO, MOTOR_R_IN1_PIN, 0);
-    GPIO_WritePinOutput(MOTOR_R_IN2_GPIO, MOTOR_R_IN2_PIN, 0);
+    Log_String("[STOP]\r\n");
     
-    UART_SendString("[STOP]\r\n");
+    // Ramp both to 0; the ISR lets them coast (IN1=0, IN2=0) at the end
+    Motor_SetTargets(0, 0);
+}
+
+void Motor_StopWith(MotorStopPolicy_t policy)
+{
+    Log_String((policy == MOTOR_STOP_COAST) ? "[STOP coast]\r\n" : "[STOP brake]\r\n");
+    
+    uint32_t primask = DisableGlobalIRQ();
+    if (!emergencyStopped) {
+        // No ramp: the profiles restart from standstill
+        Motion_Reset(&leftAxis);
+        Motion_Reset(&rightAxis);
+        Motor_Coast();
+        
+        if (policy != MOTOR_STOP_COAST) {
+            // IN1=IN2=1 on both wheels with EN at 100%: L293D fast motor stop
+            MOTOR_L_IN1_GPIO->PSOR = (1U << MOTOR_L_IN1_PIN) | (1U << MOTOR_L_IN2_PIN) | (1U << MOTOR_R_IN1_PIN);
+            MOTOR_R_IN2_GPIO->PSOR = 1U << MOTOR_R_IN2_PIN;
+            TPM0->CONTROLS[1].CnV = TPM0->MOD + 1U;  // CnV > MOD = 100% duty
+            TPM0->CONTROLS[2].CnV = TPM0->MOD + 1U;
+            
+            braking = true;
+            brakeTicks = (policy == MOTOR_STOP_BRAKE_COAST) ? MOTOR_BRAKE_TIME_MS : 0;
+        }
+        TPM0->SC = (TPM0->SC & ~TPM_SC_TOF_MASK) | TPM_SC_TOIE_MASK;  // Leave TOF alone
+    }
+    EnableGlobalIRQ(primask);
+}
+
+void Motor_EmergencyStop(void)
+{
+    emergencyStopped = true;
+    
+    // Direction pins low first: L293D coasts at once, whatever the PWM does
+    MOTOR_L_IN1_GPIO->PCOR = (1U << MOTOR_L_IN1_PIN) | (1U << MOTOR_L_IN2_PIN) | (1U << MOTOR_R_IN1_PIN);
+    MOTOR_R_IN2_GPIO->PCOR = (1U << MOTOR_R_IN2_PIN);
     
-    // Stop PWM on both
-    Motor_SetBothPWM(0, 0);
+    // CnV is latched at the next counter overflow (<= 1 PWM period)
+    TPM0->CONTROLS[1].CnV = 0;
+    TPM0->CONTROLS[2].CnV = 0;
+    
+    // No ramp: the profiles restart from standstill (TPM0 ISR is masked or idle)
+    Motion_Reset(&leftAxis);
+    Motion_Reset(&rightAxis);
+    braking = false;
+    traceIsrPending = false;
+}
+
+void Motor_ReleaseEmergencyStop(void)
+{
+    emergencyStopped = false;
+}
+
+bool Motor_IsRamping(void)
+{
+    return (TPM0->SC & TPM_SC_TOIE_MASK) != 0;
+}
+
+void Motor_TraceCommand(uint32_t arrivalUs)
+{
+    traceArrivalUs = arrivalUs;
+    traceArmed = true;
+}
+
+void Motor_TraceEnd(void)
+{
+    traceArmed = false;
 }
 
 uint8_t Motor_GetDefaultSpeed(void)
@@ -2,6 +2,7 @@
 #define MOTOR_H
 
 #include <stdint.h>
+#include <stdbool.h>
 
 /**
  * Motor Control Module for L293D Driver
@@ -11,7 +12,19 @@
  * 
  * All pins on J1 and J10 headers
  * Differential steering: turning is achieved by varying motor speeds
+ * 
+ * Speed and direction changes are ramped (motion.h): the calls below set
+ * the target and return, the TPM0 interrupt gets the wheels there.
+ */
+
+/**
+ * @brief How Motor_StopWith() takes the speed off (no ramp in any case)
  */
+typedef enum {
+    MOTOR_STOP_COAST = 0,       // IN1=IN2=0: the wheels roll out freely
+    MOTOR_STOP_BRAKE,           // IN1=IN2=1, EN 100%: motors shorted until the next command
+    MOTOR_STOP_BRAKE_COAST      // Brake for MOTOR_BRAKE_TIME_MS (motor.c), then coast
+} MotorStopPolicy_t;
 
 /**
  * @brief Initialize motor control GPIO and PWM
@@ -43,10 +56,47 @@ void Motor_TurnLeft(uint8_t speed);
 void Motor_TurnRight(uint8_t speed);
 
 /**
- * @brief Stop both motors immediately
+ * @brief Ramp both motors down to 0, then let them coast
  */
 void Motor_Stop(void);
 
+/**
+ * @brief Stop both motors at once with the given policy
+ * @note A later Motor_Stop() keeps the brake; any movement releases it
+ */
+void Motor_StopWith(MotorStopPolicy_t policy);
+
+/**
+ * @brief Cut the motors from interrupt context (no logging, no SDK calls)
+ * @note Motor_Forward/Backward/Turn* keep the PWM at 0 until
+ *       Motor_ReleaseEmergencyStop() is called
+ */
+void Motor_EmergencyStop(void);
+
+/**
+ * @brief Allow the PWM to be driven again after Motor_EmergencyStop()
+ * @note Called by the main loop once the FSM has taken the STOP command
+ *       and every command buffered before it
+ */
+void Motor_ReleaseEmergencyStop(void);
+
+/**
+ * @brief true while a motion profile is still moving (TPM0 interrupt on)
+ */
+bool Motor_IsRamping(void);
+
+/**
+ * @brief Trace a command: the first PWM update it causes records
+ *        Timebase_ElapsedUs(arrivalUs) as PROF_CMD_LATENCY
+ * @param arrivalUs Arrival time of the command (Bluetooth_GetCommandTimeUs)
+ */
+void Motor_TraceCommand(uint32_t arrivalUs);
+
+/**
+ * @brief Drop the trace if the command did not write the PWM
+ */
+void Motor_TraceEnd(void);
+
 /**
  * @brief Get default speed
  * @return Default speed percentage 0-100
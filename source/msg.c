@@ -0,0 +1,118 @@
+#include <stdarg.h>
+#include "msg.h"
+#include "uart.h"
+#include "fmt.h"
+
+/**
+ * Message encoder: one pass over the format string from messages.h,
+ * writing either the expanded text or the compact encoding into a
+ * local buffer, then a single UART_SendBuffer() call.
+ */
+
+// Longest expanded message (strings are truncated to fit)
+#define MSG_BUFFER_SIZE     96U
+
+// Worst-case size of one LEB128-encoded uint32_t
+#define VARINT_MAX_LEN      5U
+
+static const char *const messageText[MSG_COUNT] = {
+#define MESSAGE_TEXT_ENTRY(id, text)  [id] = text,
+    MESSAGE_LIST(MESSAGE_TEXT_ENTRY)
+#undef MESSAGE_TEXT_ENTRY
+};
+
+static MsgMode_t msgMode = MSG_MODE_VERBOSE;
+
+uint8_t Msg_PutVarint(uint8_t *dst, uint32_t value)
+{
+    uint8_t len = 0;
+    
+    while (value >= 0x80U) {
+        dst[len++] = (uint8_t)(value | 0x80U);
+        value >>= 7;
+    }
+    dst[len++] = (uint8_t)value;
+    return len;
+}
+
+void Msg_Send(MsgId_t id, ...)
+{
+    uint8_t buffer[MSG_BUFFER_SIZE];
+    uint32_t len = 0;
+    bool compact = (msgMode == MSG_MODE_COMPACT);
+    const char *fmt;
+    va_list args;
+    
+    if ((uint32_t)id >= MSG_COUNT) {
+        return;
+    }
+    fmt = messageText[id];
+    
+    if (compact) {
+        buffer[len++] = (uint8_t)(MSG_WIRE_BASE + id);
+    }
+    
+    va_start(args, id);
+    for (; *fmt; fmt++) {
+        uint32_t room = MSG_BUFFER_SIZE - len;
+        
+        if (*fmt != '%' || fmt[1] == '\0') {
+            if (!compact && room > 0) {
+                buffer[len++] = (uint8_t)*fmt;
+            }
+            continue;
+        }
+        
+        fmt++;
+        if (*fmt == 'u' || *fmt == 'c') {
+            uint32_t value = va_arg(args, uint32_t);
+            
+            if (compact) {
+                if (room >= VARINT_MAX_LEN) {
+                    len += Msg_PutVarint(&buffer[len], value);
+                }
+            } else if (*fmt == 'u' && room >= FMT_U32_MAX_LEN) {
+                len += Fmt_U32((char *)&buffer[len], value);
+            } else if (*fmt == 'c' && room >= FMT_CENTI_MAX_LEN) {
+                len += Fmt_Centi((char *)&buffer[len], value);
+            }
+        } else if (*fmt == 's') {
+            const char *str = va_arg(args, const char *);
+            uint32_t strLen = 0;
+            
+            while (str[strLen]) {
+                strLen++;
+            }
+            if (compact) {
+                // Length prefix must match what is actually sent
+                uint32_t maxLen = (room > VARINT_MAX_LEN) ? room - VARINT_MAX_LEN : 0;
+                if (strLen > maxLen) {
+                    strLen = maxLen;
+                }
+                if (room > 0) {
+                    len += Msg_PutVarint(&buffer[len], strLen);
+                }
+            } else if (strLen > room) {
+                strLen = room;
+            }
+            for (uint32_t i = 0; i < strLen; i++) {
+                buffer[len++] = (uint8_t)str[i];
+            }
+        } else if (*fmt == '%' && !compact && room > 0) {
+            buffer[len++] = '%';
+        }
+    }
+    va_end(args);
+    
+    UART_SendBuffer(buffer, len);
+}
+
+void Msg_SetMode(MsgMode_t mode)
+{
+    msgMode = mode;
+}
+
+MsgMode_t Msg_GetMode(void)
+{
+    return msgMode;
+}
@@ -0,0 +1,41 @@
+#ifndef MSG_H
+#define MSG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "messages.h"
+
+/**
+ * Telemetry Messages (verbose text or compact id + varints)
+ * 
+ * Verbose (default): the text from messages.h is expanded on the target,
+ * so any Bluetooth terminal app can read it.
+ * Compact: 1 byte id + varint arguments, expanded on the host by
+ * tools/msg_decode. Toggled at runtime with the 'V' command.
+ * 
+ * Each message goes to the TX buffer in one piece, so the UART drop
+ * policy never cuts a message in half (which would desync the decoder).
+ */
+
+typedef enum {
+    MSG_MODE_VERBOSE = 0,
+    MSG_MODE_COMPACT
+} MsgMode_t;
+
+/**
+ * @brief Send a message from messages.h
+ * @param id Message id
+ * @param ... One argument per placeholder: uint32_t for %u/%c, const char* for %s
+ */
+void Msg_Send(MsgId_t id, ...);
+
+/**
+ * @brief Write value as an LEB128 varint (7 bits per byte, low first)
+ * @return Bytes written (1-5)
+ */
+uint8_t Msg_PutVarint(uint8_t *dst, uint32_t value);
+
+void Msg_SetMode(MsgMode_t mode);
+MsgMode_t Msg_GetMode(void);
+
+#endif // MSG_H
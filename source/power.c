@@ -0,0 +1,163 @@
+#include "MKL25Z4.h"
+#include "fsl_smc.h"
+#include "power.h"
+#include "tick.h"
+#include "timebase.h"
+#include "events.h"
+#include "bluetooth.h"
+#include "car_fsm.h"
+#include "uart.h"
+#include "swtimer.h"
+#include "motor.h"
+#include "ultrasonic.h"
+
+// VLPS when parked, woken by UART0 RX (see power.h)
+#define POWER_ENABLE_VLPS       1
+
+// Shorter idle periods are spent awake (entry/exit cost, LPO granularity)
+#define POWER_MIN_SLEEP_MS      2U
+
+// VLPS only for longer gaps: exit in PEE waits for the PLL to relock
+#define POWER_VLPS_MIN_MS       20U
+
+static volatile bool alarmFired = false;
+static PowerStats_t stats;
+
+/**
+ * @brief LPTMR0 alarm: sleep time is over
+ */
+void LPTMR0_IRQHandler(void)
+{
+    LPTMR0->CSR |= LPTMR_CSR_TCF_MASK;  // Write 1 to clear
+    LPTMR0->CSR &= ~LPTMR_CSR_TEN_MASK;
+    alarmFired = true;
+}
+
+#if POWER_ENABLE_VLPS
+/**
+ * @brief Clear the UART0 RX active-edge flag (write 1; keep LBKDIF, also w1c)
+ */
+static inline void Power_ClearRxEdge(void)
+{
+    UART0->S2 = (uint8_t)((UART0->S2 & ~UART0_S2_LBKDIF_MASK) | UART0_S2_RXEDGIF_MASK);
+}
+#endif
+
+static void Power_StartAlarm(uint32_t ms)
+{
+    alarmFired = false;
+    LPTMR0->CSR = 0;                // Disable (also resets the counter)
+    LPTMR0->CMR = ms - 1U;
+    LPTMR0->CSR = LPTMR_CSR_TIE_MASK | LPTMR_CSR_TEN_MASK;
+}
+
+/**
+ * @brief Stop the alarm and return how long we slept, in LPTMR ms
+ */
+static uint32_t Power_StopAlarm(uint32_t requestedMs)
+{
+    uint32_t elapsed;
+    
+    if (alarmFired) {
+        elapsed = requestedMs;
+    } else {
+        LPTMR0->CNR = 0;            // Any write latches the counter for reading
+        elapsed = LPTMR0->CNR;
+    }
+    LPTMR0->CSR = 0;
+    return elapsed;
+}
+
+void Power_Init(void)
+{
+    SMC_SetPowerModeProtection(SMC, kSMC_AllowPowerModeAll);
+    
+    // LPTMR0: time counter mode, LPO 1kHz, prescaler bypassed -> 1 count = 1ms
+    SIM->SCGC5 |= SIM_SCGC5_LPTMR_MASK;
+    LPTMR0->CSR = 0;
+    LPTMR0->PSR = LPTMR_PSR_PCS(1) | LPTMR_PSR_PBYP_MASK;
+    NVIC_SetPriority(LPTMR0_IRQn, 3);
+    NVIC_EnableIRQ(LPTMR0_IRQn);
+    
+#if POWER_ENABLE_VLPS
+    // UART0 runs from OSCERCLK (board.h): keep the crystal on in stop
+    // modes so it still receives in VLPS (PLL also relocks faster)
+    OSC0->CR |= OSC_CR_EREFSTEN_MASK;
+    UART_SendString("  Power init (Wait + VLPS idle)\r\n");
+#else
+    UART_SendString("  Power init (Wait idle)\r\n");
+#endif
+}
+
+void Power_Idle(uint32_t sleepMs)
+{
+    if (sleepMs < POWER_MIN_SLEEP_MS) {
+        return;
+    }
+    
+#if POWER_ENABLE_VLPS
+    bool deep = (sleepMs >= POWER_VLPS_MIN_MS) && (FSM_GetState() == STATE_IDLE) && UART_TxIdle()
+                && !SwTimer_AnyActive() && !Motor_IsRamping()   // TPM2 / TPM0 stop in VLPS
+                && !Ultrasonic_Busy();                          // So does echo capture
+#else
+    bool deep = false;
+#endif
+    
+    // Interrupts stay masked from the check to WFI: an interrupt in between
+    // is left pending and makes WFI return at once instead of being missed
+    __disable_irq();
+    if (Bluetooth_Available() || Events_Pending()) {
+        __enable_irq();
+        return;
+    }
+    
+    uint32_t startMs = Tick_GetMs();
+    uint32_t startUs = Timebase_GetUs();
+    Tick_Suspend();
+    Power_StartAlarm(sleepMs);
+    
+    if (deep) {
+#if POWER_ENABLE_VLPS
+        // Start bit of the next byte wakes us (UART0_IRQn is enabled);
+        // the UART receives that byte itself meanwhile
+        Power_ClearRxEdge();
+        UART0->BDH |= UART0_BDH_RXEDGIE_MASK;
+        
+        SMC_PreEnterStopModes();
+        SMC_SetPowerModeVlps(SMC);
+        // Back in PEE: wait for the PLL before touching clocked peripherals
+        while (!(MCG->S & MCG_S_LOCK0_MASK)) {
+        }
+        
+        // Before interrupts come back: the edge flag would keep UART0_IRQn
+        // firing (UART0_IRQHandler does not know about it)
+        UART0->BDH &= (uint8_t)~UART0_BDH_RXEDGIE_MASK;
+        Power_ClearRxEdge();
+        SMC_PostExitStopModes();
+#endif
+    } else {
+        SMC_PreEnterWaitModes();
+        SMC_SetPowerModeWait(SMC);
+        SMC_PostExitWaitModes();  // Wake-up ISR runs here
+    }
+    
+    // Wait: the PIT timebase kept running, time the sleep to the us.
+    // VLPS: it paused with the bus clock, only the LPTMR ms count is left
+    uint32_t lptmrMs = Power_StopAlarm(sleepMs);
+    Tick_Resume(deep ? lptmrMs * 1000U : Timebase_ElapsedUs(startUs));
+    uint32_t elapsed = Tick_GetMs() - startMs;
+    __enable_irq();
+    
+    stats.wakeups++;
+    if (deep) {
+        stats.vlpsMs += elapsed;
+    } else {
+        stats.waitMs += elapsed;
+    }
+}
+
+void Power_GetStats(PowerStats_t *out)
+{
+    *out = stats;
+    out->runMs = Tick_GetMs() - stats.waitMs - stats.vlpsMs;
+}
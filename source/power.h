@@ -0,0 +1,49 @@
+#ifndef POWER_H
+#define POWER_H
+
+#include <stdint.h>
+
+/**
+ * Low-Power Idle (fsl_smc)
+ * 
+ * Scheduler idle hook: between task releases the MCU waits in a low-power
+ * mode instead of spinning.
+ *   Wait - core clock off, peripherals (UART0 + DMA, PIT, TPM) keep
+ *          running; any interrupt wakes it. Used while driving.
+ *   VLPS - bus clock and PLL stopped (POWER_ENABLE_VLPS). Only in IDLE
+ *          with the TX path empty, no software timer armed and no echo
+ *          in flight. UART0 is clocked from OSCERCLK, kept on in stop
+ *          modes, so it goes on receiving; its RX active-edge interrupt
+ *          (BDH RXEDGIE) wakes the MCU on the start bit and the PLL has
+ *          relocked before the byte is complete. No byte is lost.
+ * 
+ * SysTick stops with the core clock, so LPTMR0 (1kHz LPO) is the wake-up
+ * alarm and tick.c is told how long the MCU slept (tickless idle). Wait
+ * is timed with the PIT timebase (1us); its sub-ms remainder carries
+ * over to the next sleep instead of being lost on every wake. VLPS
+ * stops the PIT too, so it is timed in whole LPO ms.
+ */
+
+typedef struct {
+    uint32_t runMs;     // Awake (total - wait - vlps)
+    uint32_t waitMs;
+    uint32_t vlpsMs;
+    uint32_t wakeups;
+} PowerStats_t;
+
+/**
+ * @brief Allow low-power modes and set up the LPTMR wake-up alarm
+ */
+void Power_Init(void);
+
+/**
+ * @brief Sleep up to sleepMs unless work is pending (scheduler idle hook)
+ */
+void Power_Idle(uint32_t sleepMs);
+
+/**
+ * @brief Residency per power state
+ */
+void Power_GetStats(PowerStats_t *stats);
+
+#endif // POWER_H
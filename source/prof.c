@@ -0,0 +1,140 @@
+#include "prof.h"
+#include "proto.h"
+#include "msg.h"
+#include "uart.h"
+
+// Largest frame payload: header, 16-char name, every bucket used
+#define PROF_NAME_MAX       16U
+#define PROF_PAYLOAD_MAX    (4U + PROF_NAME_MAX + 5U + 5U + 1U + PROF_BUCKETS * 6U)
+
+typedef struct {
+    uint32_t buckets[PROF_BUCKETS];
+    uint32_t maxUs;
+} ProfHistogram_t;
+
+static ProfHistogram_t histograms[PROF_POINT_COUNT];
+
+static const char *const pointName[PROF_TASK_FIRST] = {
+    [PROF_ISR_UART0] = "isr_uart0",
+    [PROF_ISR_TIMER] = "isr_timer",
+    [PROF_FSM_EVENT] = "fsm_event",
+    [PROF_EVENT_AGE] = "event_age",
+    [PROF_CMD_LATENCY] = "cmd_latency",
+};
+
+/**
+ * @brief floor(log2(us)) + 1, 0 for 0 (no CLZ on Cortex-M0+)
+ */
+static inline uint32_t Prof_Bucket(uint32_t us)
+{
+    uint32_t bucket = 0;
+    
+    if (us >= (1U << 16)) { us >>= 16; bucket += 16; }
+    if (us >= (1U << 8))  { us >>= 8;  bucket += 8; }
+    if (us >= (1U << 4))  { us >>= 4;  bucket += 4; }
+    if (us >= (1U << 2))  { us >>= 2;  bucket += 2; }
+    if (us >= (1U << 1))  { us >>= 1;  bucket += 1; }
+    bucket += us;  // us is 0 or 1 here
+    
+    return (bucket < PROF_BUCKETS) ? bucket : PROF_BUCKETS - 1U;
+}
+
+void Prof_Record(ProfPoint_t point, uint32_t us)
+{
+    ProfHistogram_t *h = &histograms[point];
+    
+    h->buckets[Prof_Bucket(us)]++;
+    if (us > h->maxUs) {
+        h->maxUs = us;
+    }
+}
+
+/**
+ * @brief Upper bound of the bucket holding the sample at pct percent
+ */
+static uint32_t Prof_Percentile(const ProfHistogram_t *h, uint32_t count, uint32_t pct)
+{
+    uint32_t seen = 0;
+    
+    for (uint32_t b = 0; b < PROF_BUCKETS; b++) {
+        seen += h->buckets[b];
+        if (seen * 100U >= count * pct) {
+            uint32_t bound = (b == 0) ? 0 : (1U << b) - 1U;
+            return (bound < h->maxUs) ? bound : h->maxUs;
+        }
+    }
+    return h->maxUs;
+}
+
+void Prof_GetSummary(ProfPoint_t point, ProfSummary_t *summary)
+{
+    const ProfHistogram_t *h = &histograms[point];
+    uint32_t count = 0;
+    
+    for (uint32_t b = 0; b < PROF_BUCKETS; b++) {
+        count += h->buckets[b];
+    }
+    
+    summary->count = count;
+    summary->maxUs = h->maxUs;
+    summary->p50Us = (count != 0) ? Prof_Percentile(h, count, 50U) : 0;
+    summary->p99Us = (count != 0) ? Prof_Percentile(h, count, 99U) : 0;
+}
+
+static const char *Prof_PointName(uint32_t point)
+{
+    if (point < PROF_TASK_FIRST) {
+        return pointName[point];
+    }
+    
+    TaskStats_t task;
+    Scheduler_GetTaskStats((uint8_t)(point - PROF_TASK_FIRST), &task);
+    return task.name;
+}
+
+void Prof_Dump(void)
+{
+    uint8_t payload[PROF_PAYLOAD_MAX];
+    uint8_t frame[PROTO_ENCODED_MAX(PROF_PAYLOAD_MAX)];
+    
+    for (uint32_t point = 0; point < PROF_POINT_COUNT; point++) {
+        const ProfHistogram_t *h = &histograms[point];
+        uint32_t count = 0;
+        uint8_t used = 0;
+        
+        for (uint32_t b = 0; b < PROF_BUCKETS; b++) {
+            count += h->buckets[b];
+            used += (h->buckets[b] != 0);
+        }
+        if (count == 0) {
+            continue;
+        }
+        
+        const char *name = Prof_PointName(point);
+        uint16_t len = 0;
+        uint8_t nameLen = 0;
+        
+        payload[len++] = PROTO_VERSION;
+        payload[len++] = PROF_FRAME_TYPE;
+        payload[len++] = (uint8_t)point;
+        while (name[nameLen] != '\0' && nameLen < PROF_NAME_MAX) {
+            payload[len + 1U + nameLen] = (uint8_t)name[nameLen];
+            nameLen++;
+        }
+        payload[len] = nameLen;
+        len += 1U + nameLen;
+        len += Msg_PutVarint(&payload[len], count);
+        len += Msg_PutVarint(&payload[len], h->maxUs);
+        payload[len++] = used;
+        for (uint32_t b = 0; b < PROF_BUCKETS; b++) {
+            if (h->buckets[b] != 0) {
+                payload[len++] = (uint8_t)b;
+                len += Msg_PutVarint(&payload[len], h->buckets[b]);
+            }
+        }
+        
+        // One frame per point: under UART_TX_DROP a full TX buffer loses
+        // whole points, never half a frame
+        UART_SendBuffer(frame, Proto_EncodeFrame(payload, len, frame));
+    }
+}
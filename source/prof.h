@@ -0,0 +1,76 @@
+#ifndef PROF_H
+#define PROF_H
+
+#include <stdint.h>
+#include "scheduler.h"
+#include "timebase.h"
+
+/**
+ * Latency Profiler (log2 histograms on the microsecond timebase)
+ * 
+ * Each profiling point keeps a histogram of durations in RAM:
+ * bucket 0 = 0us, bucket b = [2^(b-1), 2^b) us, the last bucket also
+ * takes everything longer. Recording is a handful of compares and one
+ * increment, cheap enough for every ISR entry.
+ * 
+ * Every point is recorded from one context only (its ISR, or the main
+ * loop), so the counters need no locking.
+ * 
+ * 'Z' sends one binary frame per point (Proto_EncodeFrame framing):
+ *   version | 'H' | point | nameLen | name | count | maxUs |
+ *   buckets | { bucket | count }...      (count/maxUs: varints,
+ *                                          only non-empty buckets)
+ * tools/prof_report turns a capture into percentiles.
+ */
+
+#define PROF_ENABLED        1
+
+#define PROF_BUCKETS        20U     // Last bucket: >= 2^18 us (262ms)
+#define PROF_FRAME_TYPE     'H'
+
+typedef enum {
+    PROF_ISR_UART0 = 0,     // UART0_IRQHandler (RX burst, STOP fast path)
+    PROF_ISR_TIMER,         // TPM2_IRQHandler (software timer tick + callbacks)
+    PROF_FSM_EVENT,         // FSM_ProcessEvent, events that change/refresh state
+    PROF_EVENT_AGE,         // Event posted -> taken by the FSM (queue wait only)
+    PROF_CMD_LATENCY,       // Command byte received -> motor PWM written (motor.c)
+    PROF_TASK_FIRST,        // Scheduler tasks, in priority order
+    PROF_POINT_COUNT = PROF_TASK_FIRST + SCHEDULER_MAX_TASKS
+} ProfPoint_t;
+
+/**
+ * @brief Add one duration to a point's histogram
+ */
+void Prof_Record(ProfPoint_t point, uint32_t us);
+
+/**
+ * @brief Percentiles of one point, as the upper bound of the bucket holding them
+ */
+typedef struct {
+    uint32_t count;
+    uint32_t p50Us;
+    uint32_t p99Us;
+    uint32_t maxUs;
+} ProfSummary_t;
+
+/**
+ * @brief Summarize a point's histogram on the target (see tools/prof_report
+ *        for interpolated percentiles)
+ */
+void Prof_GetSummary(ProfPoint_t point, ProfSummary_t *summary);
+
+/**
+ * @brief Send every non-empty histogram as binary frames
+ */
+void Prof_Dump(void);
+
+// Instrumentation helpers (compile to nothing when PROF_ENABLED is 0)
+#if PROF_ENABLED
+#define PROF_START(var)         uint32_t var = Timebase_GetUs()
+#define PROF_END(point, var)    Prof_Record((point), Timebase_ElapsedUs(var))
+#else
+#define PROF_START(var)
+#define PROF_END(point, var)
+#endif
+
+#endif // PROF_H
@@ -0,0 +1,303 @@
+#include "proto.h"
+
+/**
+ * Incremental COBS decoder + payload parser
+ * 
+ * COBS: each block starts with a code byte n; n-1 data bytes follow and,
+ * unless n == 0xFF, an implicit zero comes after them. The implicit zero
+ * is only emitted when the next block starts, because the last block of
+ * a frame has none.
+ * 
+ * The last two decoded bytes are the CRC, which is only known once the
+ * closing delimiter arrives, so decoded bytes pass through a 2-byte delay
+ * line before they reach the CRC and the command parser.
+ */
+
+typedef enum {
+    RX_ASCII = 0,   // Not in a frame
+    RX_FRAME,       // Inside a frame
+    RX_SKIP         // Frame rejected, discard until delimiter
+} RxMode_t;
+
+typedef enum {
+    FIELD_VERSION = 0,
+    FIELD_ID,
+    FIELD_LEN,
+    FIELD_ARGS
+} Field_t;
+
+static RxMode_t mode = RX_ASCII;
+
+// COBS state
+static uint8_t cobsRemaining = 0;   // Data bytes left in the current block
+static bool cobsZeroPending = false;
+static uint8_t decodedLen = 0;
+static uint8_t rawLen = 0;          // Encoded bytes since the opening delimiter
+
+// CRC delay line
+static uint8_t delay[2];
+static uint8_t delayCount = 0;
+static uint16_t crc = 0xFFFFU;
+
+// Payload parser
+static Field_t field = FIELD_VERSION;
+static uint8_t argsLeft = 0;
+static bool firstArg = false;
+static bool formatError = false;
+
+// Parsed commands (staged until the CRC checks out)
+static ProtoCommand_t commands[PROTO_MAX_COMMANDS];
+static uint8_t commandCount = 0;
+static uint8_t commandRead = 0;
+static bool commandsReady = false;
+
+static ProtoStats_t stats;
+
+// CRC-16/CCITT nibble table: 32 bytes of flash instead of 512
+static const uint16_t crcNibble[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+uint16_t Proto_Crc16Update(uint16_t value, uint8_t byte)
+{
+    value = (uint16_t)((value << 4) ^ crcNibble[(value >> 12) ^ (byte >> 4)]);
+    value = (uint16_t)((value << 4) ^ crcNibble[(value >> 12) ^ (byte & 0x0FU)]);
+    return value;
+}
+
+uint16_t Proto_EncodeFrame(const uint8_t *payload, uint16_t len, uint8_t *out)
+{
+    uint16_t value = 0xFFFFU;
+    uint16_t pos = 1;
+    uint16_t codePos = 1;   // Where the current block's code byte goes
+    uint8_t code = 1;
+    
+    out[0] = PROTO_DELIMITER;
+    out[pos++] = 0;         // Placeholder for the first code byte
+    
+    for (uint16_t i = 0; i < len + 2U; i++) {
+        uint8_t byte;
+        
+        if (i < len) {
+            byte = payload[i];
+            value = Proto_Crc16Update(value, byte);
+        } else {
+            byte = (i == len) ? (uint8_t)(value >> 8) : (uint8_t)value;  // CRC, MSB first
+        }
+        
+        if (byte == 0) {
+            out[codePos] = code;
+            codePos = pos++;
+            code = 1;
+        } else {
+            out[pos++] = byte;
+            if (++code == 0xFFU) {
+                out[codePos] = code;
+                codePos = pos++;
+                code = 1;
+            }
+        }
+    }
+    out[codePos] = code;
+    out[pos++] = PROTO_DELIMITER;
+    return pos;
+}
+
+static void Proto_StartFrame(void)
+{
+    mode = RX_FRAME;
+    cobsRemaining = 0;
+    cobsZeroPending = false;
+    decodedLen = 0;
+    rawLen = 0;
+    delayCount = 0;
+    crc = 0xFFFFU;
+    field = FIELD_VERSION;
+    argsLeft = 0;
+    formatError = false;
+    commandCount = 0;
+    commandRead = 0;
+    commandsReady = false;
+}
+
+/**
+ * @brief Payload byte (CRC already stripped by the delay line)
+ */
+static void Proto_ParseByte(uint8_t byte)
+{
+    crc = Proto_Crc16Update(crc, byte);
+    
+    switch (field) {
+        case FIELD_VERSION:
+            if (byte != PROTO_VERSION) {
+                formatError = true;
+            }
+            field = FIELD_ID;
+            break;
+            
+        case FIELD_ID:
+            if (commandCount >= PROTO_MAX_COMMANDS) {
+                formatError = true;
+                break;
+            }
+            commands[commandCount].id = byte;
+            commands[commandCount].arg = 0;
+            field = FIELD_LEN;
+            break;
+            
+        case FIELD_LEN:
+            argsLeft = byte;
+            firstArg = true;
+            if (argsLeft == 0) {
+                commandCount++;
+                field = FIELD_ID;
+            } else {
+                field = FIELD_ARGS;
+            }
+            break;
+            
+        case FIELD_ARGS:
+            // Keep the first argument byte, skip any we do not know about
+            if (firstArg) {
+                commands[commandCount].arg = byte;
+                firstArg = false;
+            }
+            if (--argsLeft == 0) {
+                commandCount++;
+                field = FIELD_ID;
+            }
+            break;
+    }
+}
+
+/**
+ * @brief One COBS-decoded byte
+ */
+static void Proto_EmitDecoded(uint8_t byte)
+{
+    if (++decodedLen > PROTO_MAX_FRAME_LEN) {
+        formatError = true;
+        return;
+    }
+    
+    if (delayCount == 2) {
+        Proto_ParseByte(delay[0]);
+        delay[0] = delay[1];
+        delay[1] = byte;
+    } else {
+        delay[delayCount++] = byte;
+    }
+}
+
+/**
+ * @brief Closing delimiter: check CRC and release the commands
+ */
+static ProtoStatus_t Proto_EndFrame(void)
+{
+    mode = RX_ASCII;
+    
+    if (formatError || cobsRemaining != 0 || delayCount < 2 || field != FIELD_ID) {
+        stats.formatErrors++;
+        return PROTO_FRAME_ERROR;
+    }
+    
+    if ((uint16_t)((delay[0] << 8) | delay[1]) != crc) {
+        stats.crcErrors++;
+        return PROTO_FRAME_ERROR;
+    }
+    
+    stats.framesOk++;
+    commandRead = 0;
+    commandsReady = true;
+    return PROTO_FRAME_OK;
+}
+
+void Proto_Reset(void)
+{
+    mode = RX_ASCII;
+    commandCount = 0;
+    commandRead = 0;
+    commandsReady = false;
+}
+
+bool Proto_InFrame(void)
+{
+    return (mode != RX_ASCII);
+}
+
+ProtoStatus_t Proto_Timeout(void)
+{
+    RxMode_t was = mode;
+    
+    mode = RX_ASCII;
+    if (was != RX_FRAME) {
+        return PROTO_IDLE;  // Not in a frame, or already counted (RX_SKIP)
+    }
+    stats.formatErrors++;
+    return PROTO_FRAME_ERROR;
+}
+
+ProtoStatus_t Proto_Feed(uint8_t byte)
+{
+    if (byte == PROTO_DELIMITER) {
+        if (mode == RX_FRAME && rawLen > 0) {
+            return Proto_EndFrame();
+        }
+        if (mode == RX_SKIP) {
+            mode = RX_ASCII;
+            return PROTO_IDLE;
+        }
+        Proto_StartFrame();  // Opening delimiter (or back-to-back 0x00)
+        return PROTO_IDLE;
+    }
+    
+    if (mode == RX_ASCII) {
+        return PROTO_IDLE;
+    }
+    
+    // Longer than any valid frame (a stray 0x00, or a lost closing one):
+    // hand the link back to the ASCII parser instead of waiting for 0x00
+    if (++rawLen > PROTO_MAX_ENCODED_LEN) {
+        return Proto_Timeout();
+    }
+    
+    if (mode != RX_FRAME) {
+        return PROTO_IDLE;
+    }
+    
+    if (cobsRemaining == 0) {
+        // Code byte: starts a new block
+        if (cobsZeroPending) {
+            Proto_EmitDecoded(0);
+        }
+        cobsRemaining = byte - 1U;
+        cobsZeroPending = (byte != 0xFFU);
+    } else {
+        Proto_EmitDecoded(byte);
+        cobsRemaining--;
+    }
+    
+    if (formatError) {
+        stats.formatErrors++;
+        mode = RX_SKIP;
+        return PROTO_FRAME_ERROR;
+    }
+    return PROTO_IDLE;
+}
+
+bool Proto_PopCommand(ProtoCommand_t *cmd)
+{
+    if (!commandsReady || commandRead >= commandCount) {
+        commandsReady = false;
+        return false;
+    }
+    
+    *cmd = commands[commandRead++];
+    return true;
+}
+
+void Proto_GetStats(ProtoStats_t *out)
+{
+    *out = stats;
+}
@@ -0,0 +1,110 @@
+#ifndef PROTO_H
+#define PROTO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Binary Framed Command Protocol (v1)
+ * 
+ * Runs next to the single-character ASCII protocol on the same link.
+ * A 0x00 byte (never sent by ASCII terminals) switches the receiver into
+ * frame mode; the closing 0x00 switches it back. A frame cut off before
+ * its closing 0x00 (link lost mid-frame) must not hold the link in frame
+ * mode, so it also ends - as a format error - after PROTO_FRAME_GAP_US
+ * without a byte (Proto_Timeout) or once it is longer than any valid
+ * frame (PROTO_MAX_ENCODED_LEN); the bytes after that are ASCII again.
+ * 
+ * Wire format:  0x00 | COBS(payload) | 0x00
+ * Payload:      version(1) | command | command | ... | crc16(2, MSB first)
+ * Command:      id(1) | len(1) | arg[len]
+ * 
+ *   id     = BluetoothCommand value (bluetooth.h)
+ *   arg[0] = speed 0-100 for CMD_SET_SPEED, otherwise len = 0
+ *   crc16  = CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) over
+ *            version + commands
+ * 
+ * Example - speed 55% then forward:
+ *   payload 01 | 0D 01 37 | 01 00 | crc
+ * 
+ * The parser is incremental and zero-copy: bytes are COBS-decoded, CRC'd
+ * and parsed one at a time straight from the RX ring buffer. Only the
+ * parsed commands are kept, and they are released after the CRC matched.
+ */
+
+#define PROTO_VERSION           1U
+#define PROTO_DELIMITER         0x00U
+#define PROTO_MAX_FRAME_LEN     64U     // Decoded payload bytes (incl. CRC)
+#define PROTO_MAX_COMMANDS      8U      // Commands per frame
+#define PROTO_MAX_ENCODED_LEN   (PROTO_MAX_FRAME_LEN + 1U)  // COBS bytes between the delimiters
+#define PROTO_FRAME_GAP_US      20000U  // Silence that ends an unfinished frame
+
+typedef struct {
+    uint8_t id;     // BluetoothCommand value
+    uint8_t arg;    // First argument byte (0 if none)
+} ProtoCommand_t;
+
+typedef enum {
+    PROTO_IDLE = 0,     // Byte consumed, nothing to report
+    PROTO_FRAME_OK,     // Frame complete, commands ready for Proto_PopCommand
+    PROTO_FRAME_ERROR   // Frame rejected (CRC, version, format)
+} ProtoStatus_t;
+
+typedef struct {
+    uint32_t framesOk;
+    uint32_t crcErrors;
+    uint32_t formatErrors;  // Bad version, truncated or oversized frame
+} ProtoStats_t;
+
+/**
+ * @brief Reset the parser to ASCII mode and drop pending commands
+ */
+void Proto_Reset(void);
+
+/**
+ * @brief true while between an opening and closing 0x00
+ */
+bool Proto_InFrame(void);
+
+/**
+ * @brief The link was silent for PROTO_FRAME_GAP_US: drop an unfinished
+ *        frame and return to ASCII mode
+ * @return PROTO_FRAME_ERROR if a frame was dropped, else PROTO_IDLE
+ */
+ProtoStatus_t Proto_Timeout(void);
+
+/**
+ * @brief Feed one received byte to the frame parser
+ * @note Call for every byte while Proto_InFrame(), and for PROTO_DELIMITER
+ */
+ProtoStatus_t Proto_Feed(uint8_t byte);
+
+/**
+ * @brief Take the next command of the last valid frame
+ * @return false when no command is pending
+ */
+bool Proto_PopCommand(ProtoCommand_t *cmd);
+
+/**
+ * @brief Frame counters
+ */
+void Proto_GetStats(ProtoStats_t *stats);
+
+/**
+ * @brief Update a CRC-16/CCITT-FALSE with one byte (start with 0xFFFF)
+ */
+uint16_t Proto_Crc16Update(uint16_t crc, uint8_t byte);
+
+// Worst-case Proto_EncodeFrame() output for a payload of len bytes
+#define PROTO_ENCODED_MAX(len)  ((len) + 2U + ((len) + 2U) / 254U + 1U + 2U)
+
+/**
+ * @brief Build a frame for the host: 0x00 | COBS(payload, crc16) | 0x00
+ * @param out At least PROTO_ENCODED_MAX(len) bytes
+ * @return Bytes written to out
+ * @note Same framing and CRC as received frames; the payload layout is
+ *       up to the sender (first byte PROTO_VERSION, then a type byte)
+ */
+uint16_t Proto_EncodeFrame(const uint8_t *payload, uint16_t len, uint8_t *out);
+
+#endif // PROTO_H
@@ -0,0 +1,199 @@
+#include "range_filter.h"
+
+// Gate: how far a sample may be from the estimate and still be believed
+#define RANGE_FILTER_NOISE_CM       4U      // HC-SR04 jitter plus a target edge
+#define RANGE_FILTER_RATE_CM_S      200U    // Fastest closing speed (car at 100% + moving target)
+#define RANGE_FILTER_NEAR_SLACK_CM  (2U * RANGE_FILTER_NOISE_CM)  // Near lock: jitter of both samples
+#define RANGE_FILTER_CLOSING_SHIFT  3U      // Closing speed: 1/8 of each new measurement
+
+// Confidence steps (0-100)
+#define CONF_ACCEPT     25U
+#define CONF_OUTLIER    20U
+#define CONF_RELOCK     50U     // = OBSTACLE_MIN_CONFIDENCE: act on a new target right away
+
+#define SINCE_MAX_MS    0xFFFFU
+
+static inline uint16_t RangeFilter_AddMs(uint16_t ms, uint32_t dtMs)
+{
+    uint32_t sum = ms + dtMs;
+    
+    return (sum > SINCE_MAX_MS) ? SINCE_MAX_MS : (uint16_t)sum;
+}
+
+static inline uint32_t RangeFilter_AbsDiff(uint32_t a, uint32_t b)
+{
+    return (a > b) ? a - b : b - a;
+}
+
+static inline uint32_t RangeFilter_Gate(uint32_t elapsedMs)
+{
+    return RANGE_FILTER_NOISE_CM + (RANGE_FILTER_RATE_CM_S * elapsedMs) / 1000U;
+}
+
+/**
+ * @brief Closing speed from fromCm to toCm over elapsedMs, 0..RATE cm/s
+ */
+static uint16_t RangeFilter_Closing(uint16_t fromCm, uint16_t toCm, uint32_t elapsedMs)
+{
+    uint32_t speed;
+    
+    if (toCm >= fromCm || elapsedMs == 0) {
+        return 0;
+    }
+    speed = ((uint32_t)(fromCm - toCm) * 1000U) / elapsedMs;
+    return (speed > RANGE_FILTER_RATE_CM_S) ? (uint16_t)RANGE_FILTER_RATE_CM_S : (uint16_t)speed;
+}
+
+static inline uint16_t RangeFilter_Newest(const RangeFilter_t *filter)
+{
+    return filter->window[(filter->head + RANGE_FILTER_WINDOW - 1U) % RANGE_FILTER_WINDOW];
+}
+
+static void RangeFilter_Push(RangeFilter_t *filter, uint16_t cm)
+{
+    filter->window[filter->head] = cm;
+    filter->head = (uint8_t)((filter->head + 1U) % RANGE_FILTER_WINDOW);
+    if (filter->count < RANGE_FILTER_WINDOW) {
+        filter->count++;
+    }
+}
+
+/**
+ * @brief Median of the window (the nearer middle one while it is filling),
+ *        or the newest sample if that is nearer
+ *
+ * Closing in, the median would only add lag; a far ghost that got into
+ * the window must not hold the estimate back either.
+ */
+static uint16_t RangeFilter_Median(const RangeFilter_t *filter)
+{
+    uint16_t sorted[RANGE_FILTER_WINDOW];
+    uint8_t n = filter->count;
+    uint16_t newest = RangeFilter_Newest(filter);
+    
+    // Insertion sort, n <= RANGE_FILTER_WINDOW
+    for (uint8_t i = 0; i < n; i++) {
+        uint16_t v = filter->window[i];
+        uint8_t j = i;
+        
+        while (j > 0 && sorted[j - 1] > v) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = v;
+    }
+    return (newest < sorted[(n - 1U) / 2U]) ? newest : sorted[(n - 1U) / 2U];
+}
+
+static inline void RangeFilter_Raise(RangeFilter_t *filter, uint8_t step)
+{
+    filter->confidence = (filter->confidence + step > 100U) ? 100U : (uint8_t)(filter->confidence + step);
+}
+
+static inline void RangeFilter_Lower(RangeFilter_t *filter, uint8_t step)
+{
+    filter->confidence = (filter->confidence > step) ? (uint8_t)(filter->confidence - step) : 0U;
+}
+
+void RangeFilter_Reset(RangeFilter_t *filter)
+{
+    filter->candidateCm = 0;
+    filter->previousCm = 0;
+    filter->estimateCm = 0;
+    filter->sinceMs = 0;
+    filter->candidateMs = 0;
+    filter->previousMs = 0;
+    filter->closingCmS = 0;
+    filter->head = 0;
+    filter->count = 0;
+    filter->outliers = 0;
+    filter->misses = 0;
+    filter->confidence = 0;
+}
+
+void RangeFilter_Update(RangeFilter_t *filter, uint32_t distanceCm, bool valid, uint32_t dtMs)
+{
+    uint32_t since = filter->sinceMs + dtMs;
+    
+    filter->sinceMs = RangeFilter_AddMs(filter->sinceMs, dtMs);
+    filter->candidateMs = RangeFilter_AddMs(filter->candidateMs, dtMs);
+    filter->previousMs = RangeFilter_AddMs(filter->previousMs, dtMs);
+    
+    // Between samples the target keeps coming closer at the tracked speed
+    if (filter->count > 0 && filter->closingCmS > 0) {
+        uint32_t step = ((uint32_t)filter->closingCmS * dtMs) / 1000U;
+        
+        filter->estimateCm = (filter->estimateCm > step + 1U) ? (uint16_t)(filter->estimateCm - step) : 1U;
+    }
+    
+    if (!valid || distanceCm == 0) {
+        // Dropout: hold the estimate for a while, a wall does not vanish.
+        // Confidence stays, a missing echo says nothing about the target
+        if (filter->misses > 0) {
+            filter->outliers = 0;  // Agreeing outliers: one dropout between at most
+        }
+        if (filter->misses < RANGE_FILTER_HOLD) {
+            filter->misses++;
+        } else {
+            RangeFilter_Reset(filter);
+        }
+        return;
+    }
+    
+    uint16_t cm = (distanceCm > 0xFFFFU) ? 0xFFFFU : (uint16_t)distanceCm;
+    
+    filter->misses = 0;
+    
+    // No estimate yet: every sample is an outlier, so a (re)lock takes
+    // RANGE_FILTER_RELOCK (3) agreeing samples, RANGE_FILTER_NEAR_LOCK (2)
+    // closing in, and comes back at CONF_RELOCK (50) - exactly the
+    // obstacle task's threshold (OBSTACLE_MIN_CONFIDENCE), which relies on
+    // it not being lower
+    if (filter->count > 0 && RangeFilter_AbsDiff(cm, filter->estimateCm) <= RangeFilter_Gate(filter->sinceMs)) {
+        uint16_t closing = RangeFilter_Closing(RangeFilter_Newest(filter), cm, since);
+        
+        filter->closingCmS = (uint16_t)((filter->closingCmS * ((1U << RANGE_FILTER_CLOSING_SHIFT) - 1U) + closing) >>
+                                        RANGE_FILTER_CLOSING_SHIFT);
+        RangeFilter_Push(filter, cm);
+        filter->outliers = 0;
+        filter->sinceMs = 0;
+        RangeFilter_Raise(filter, CONF_ACCEPT);
+        filter->estimateCm = RangeFilter_Median(filter);
+        return;
+    }
+    
+    // Outlier; agreeing ones (a ghost may fall between) mean the scene changed
+    if (filter->outliers > 0 && RangeFilter_AbsDiff(cm, filter->candidateCm) <= RangeFilter_Gate(filter->candidateMs)) {
+        filter->outliers++;
+    } else if (filter->outliers > 0 && filter->previousCm != 0 &&
+               RangeFilter_AbsDiff(cm, filter->previousCm) <= RangeFilter_Gate(filter->previousMs)) {
+        filter->candidateCm = filter->previousCm;
+        filter->candidateMs = filter->previousMs;
+        filter->outliers = 2;
+    } else {
+        filter->outliers = 1;
+    }
+    
+    bool approaching = (filter->count == 0 || cm < filter->estimateCm) &&
+                       cm <= filter->candidateCm + RANGE_FILTER_NEAR_SLACK_CM;
+    
+    if (filter->outliers >= RANGE_FILTER_RELOCK || (filter->outliers >= RANGE_FILTER_NEAR_LOCK && approaching)) {
+        filter->closingCmS = RangeFilter_Closing(filter->candidateCm, cm, filter->candidateMs);
+        filter->count = 0;
+        filter->head = 0;
+        RangeFilter_Push(filter, filter->candidateCm);
+        RangeFilter_Push(filter, cm);
+        filter->outliers = 0;
+        filter->sinceMs = 0;
+        if (filter->confidence < CONF_RELOCK) {
+            filter->confidence = CONF_RELOCK;
+        }
+        filter->estimateCm = RangeFilter_Median(filter);
+    } else {
+        RangeFilter_Lower(filter, CONF_OUTLIER);
+    }
+    filter->previousCm = filter->candidateCm;
+    filter->previousMs = filter->candidateMs;
+    filter->candidateCm = cm;
+    filter->candidateMs = 0;
+}
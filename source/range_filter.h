@@ -0,0 +1,82 @@
+#ifndef RANGE_FILTER_H
+#define RANGE_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Range Filter (per-sensor streaming filter, no hardware access)
+ *
+ * Raw HC-SR04 samples are noisy in two ways that matter here: a spurious
+ * near echo (floor, cable, the other sensor) would stop the car, and a
+ * dropout (soft or angled target) would hide a wall for a ping. Each
+ * sample goes through:
+ *
+ * - Rate gate: a sample further from the current estimate than the car
+ *   can close in the elapsed time (plus noise) is an outlier and is kept
+ *   out of the window. RANGE_FILTER_RELOCK outliers in a row that agree
+ *   with each other mean the scene really changed (something stepped in
+ *   front): the window restarts from them. A near target must not wait
+ *   that long, so two agreeing outliers are enough when the second one
+ *   is nearer than the estimate (or there is none) and not further than
+ *   the first: a target being approached. With no estimate yet every
+ *   sample is an outlier, so the first target is locked on the same way
+ *   - a lone ghost echo never is. One dropout or one ghost between the
+ *   agreeing outliers does not break the sequence.
+ * - Estimate: the nearer of the median of the last RANGE_FILTER_WINDOW
+ *   accepted samples and the newest one (no lag closing in), moved on
+ *   at the tracked closing speed between samples.
+ * - Dropouts keep extrapolating the estimate (a wall does not vanish,
+ *   nor stop coming closer) for up to RANGE_FILTER_HOLD samples, then
+ *   the estimate is dropped.
+ * - Confidence 0-100: up on accepted samples, down on outliers. Act on
+ *   the estimate only from a minimum confidence on; a lock starts at 50,
+ *   the obstacle task's minimum.
+ *
+ * Integer cm and ms, fixed-size state in the caller's struct. Plain C so
+ * tools/ can run the same filter on recorded traces.
+ */
+
+#define RANGE_FILTER_WINDOW     3U      // Median length (odd); adds (N-1)/2 samples lag
+#define RANGE_FILTER_HOLD       4U      // Dropouts bridged before the estimate is dropped
+#define RANGE_FILTER_RELOCK     3U      // Agreeing outliers in a row that restart the window
+#define RANGE_FILTER_NEAR_LOCK  2U      // Same, for a target being approached
+
+typedef struct {
+    uint16_t window[RANGE_FILTER_WINDOW];   // Accepted samples, cm (ring)
+    uint16_t candidateCm;   // Last outlier (relock check)
+    uint16_t previousCm;    // Outlier before it (a ghost in between)
+    uint16_t estimateCm;    // Median, 0 = no estimate
+    uint16_t sinceMs;       // Time since the last accepted sample (gate width)
+    uint16_t candidateMs;   // Age of candidateCm
+    uint16_t previousMs;    // Age of previousCm
+    uint16_t closingCmS;    // Tracked closing speed, 0 = holding or receding
+    uint8_t head;           // Next window slot
+    uint8_t count;          // Samples in the window
+    uint8_t outliers;       // Agreeing outliers in a row
+    uint8_t misses;         // Dropouts in a row
+    uint8_t confidence;     // 0-100
+} RangeFilter_t;
+
+/**
+ * @brief No estimate, confidence 0
+ */
+void RangeFilter_Reset(RangeFilter_t *filter);
+
+/**
+ * @brief Feed one sample
+ * @param distanceCm Raw distance (ignored unless valid)
+ * @param valid false for no echo / rejected echo
+ * @param dtMs Time since the previous sample
+ */
+void RangeFilter_Update(RangeFilter_t *filter, uint32_t distanceCm, bool valid, uint32_t dtMs);
+
+/**
+ * @brief true if there is an estimate (filter->estimateCm)
+ */
+static inline bool RangeFilter_Valid(const RangeFilter_t *filter)
+{
+    return filter->estimateCm != 0;
+}
+
+#endif // RANGE_FILTER_H
@@ -0,0 +1,142 @@
+#include "scheduler.h"
+#include <stddef.h>
+#include "tick.h"
+#include "prof.h"
+
+typedef struct {
+    TaskFunction_t function;
+    uint16_t periodMs;
+    uint16_t deadlineMs;
+    uint8_t priority;
+    uint32_t releaseMs;     // Next release time
+    TaskStats_t stats;
+} Task_t;
+
+// Sorted by priority (insertion order within one priority)
+static Task_t tasks[SCHEDULER_MAX_TASKS];
+static uint8_t taskCount = 0;
+
+static void (*idleHook)(uint32_t sleepMs) = NULL;
+
+bool Scheduler_AddTask(const char *name, TaskFunction_t function,
+                       uint16_t periodMs, uint16_t deadlineMs, uint8_t priority)
+{
+    uint8_t pos;
+    
+    if (taskCount >= SCHEDULER_MAX_TASKS) {
+        return false;
+    }
+    
+    // Insertion sort: shift lower-priority tasks down
+    for (pos = taskCount; pos > 0 && tasks[pos - 1].priority > priority; pos--) {
+        tasks[pos] = tasks[pos - 1];
+    }
+    
+    Task_t *task = &tasks[pos];
+    task->function = function;
+    task->periodMs = periodMs;
+    task->deadlineMs = deadlineMs;
+    task->priority = priority;
+    task->releaseMs = Tick_GetMs();
+    task->stats = (TaskStats_t){ .name = name };
+    
+    taskCount++;
+    return true;
+}
+
+static void Scheduler_RunTask(Task_t *task, uint32_t now)
+{
+    uint32_t release = (task->periodMs == 0) ? now : task->releaseMs;
+    uint32_t late = now - release;
+    
+    task->function();
+    
+    uint32_t end = Tick_GetMs();
+    uint32_t runMs = end - now;
+    
+    task->stats.runs++;
+    if (late > task->stats.maxLateMs) task->stats.maxLateMs = late;
+    if (runMs > task->stats.maxRunMs) task->stats.maxRunMs = runMs;
+    if (end - release > task->deadlineMs) {
+        task->stats.overruns++;
+    }
+    
+    if (task->periodMs == 0) {
+        return;
+    }
+    
+    // Next slot on the fixed grid; whole periods already missed are skipped
+    task->releaseMs += task->periodMs;
+    while ((int32_t)(end - task->releaseMs) >= (int32_t)task->periodMs) {
+        task->releaseMs += task->periodMs;
+        task->stats.overruns++;
+    }
+}
+
+void Scheduler_RunPending(void)
+{
+    for (uint8_t i = 0; i < taskCount; i++) {
+        Task_t *task = &tasks[i];
+        uint32_t now = Tick_GetMs();
+        
+        if (task->periodMs == 0 || (int32_t)(now - task->releaseMs) >= 0) {
+            PROF_START(startUs);
+            Scheduler_RunTask(task, now);
+            PROF_END((ProfPoint_t)(PROF_TASK_FIRST + i), startUs);
+        }
+    }
+}
+
+/**
+ * @brief Time until the next periodic release (0 if one is already due)
+ */
+static uint32_t Scheduler_TimeToNextRelease(void)
+{
+    uint32_t now = Tick_GetMs();
+    uint32_t best = UINT32_MAX;
+    
+    for (uint8_t i = 0; i < taskCount; i++) {
+        if (tasks[i].periodMs == 0) {
+            continue;
+        }
+        int32_t wait = (int32_t)(tasks[i].releaseMs - now);
+        if (wait <= 0) {
+            return 0;
+        }
+        if ((uint32_t)wait < best) {
+            best = (uint32_t)wait;
+        }
+    }
+    return best;
+}
+
+void Scheduler_Run(void)
+{
+    while (1) {
+        Scheduler_RunPending();
+        
+        if (idleHook != NULL) {
+            uint32_t sleepMs = Scheduler_TimeToNextRelease();
+            if (sleepMs > 0) {
+                idleHook(sleepMs);
+            }
+        }
+    }
+}
+
+void Scheduler_SetIdleHook(void (*hook)(uint32_t sleepMs))
+{
+    idleHook = hook;
+}
+
+uint8_t Scheduler_GetTaskCount(void)
+{
+    return taskCount;
+}
+
+void Scheduler_GetTaskStats(uint8_t index, TaskStats_t *stats)
+{
+    if (index < taskCount) {
+        *stats = tasks[index].stats;
+    }
+}
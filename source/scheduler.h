@@ -0,0 +1,67 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Cooperative Time-Triggered Scheduler (SysTick, 1ms)
+ * 
+ * Tasks are plain functions that run to completion. Each pass of
+ * Scheduler_Run() walks the task list in priority order and runs every
+ * task that is due, once. Periodic tasks are released on a fixed grid
+ * (release += period), so their rate does not drift with how long the
+ * rest of the loop takes. Period 0 means "every pass" (as soon as possible).
+ * 
+ * Overrun: a task finished later than release + deadline, or one or more
+ * whole periods were skipped because the loop was busy.
+ */
+
+#define SCHEDULER_MAX_TASKS     8U
+
+typedef void (*TaskFunction_t)(void);
+
+typedef struct {
+    const char *name;
+    uint32_t runs;
+    uint32_t overruns;      // Deadline misses + skipped periods
+    uint32_t maxLateMs;     // Worst release -> start delay
+    uint32_t maxRunMs;      // Worst execution time
+} TaskStats_t;
+
+/**
+ * @brief Register a task (first release is immediate)
+ * @param name       For statistics output
+ * @param function   Task body, must not block for long
+ * @param periodMs   Release period, 0 = every pass
+ * @param deadlineMs Latest completion after release
+ * @param priority   0 = most important; equal priorities keep add order
+ * @return false if the task table is full
+ */
+bool Scheduler_AddTask(const char *name, TaskFunction_t function,
+                       uint16_t periodMs, uint16_t deadlineMs, uint8_t priority);
+
+/**
+ * @brief Run one pass over the task list
+ */
+void Scheduler_RunPending(void);
+
+/**
+ * @brief Run passes forever
+ */
+void Scheduler_Run(void);
+
+/**
+ * @brief Called after each pass with the time until the next periodic release
+ * @note The hook may sleep up to sleepMs; it must check for ASAP work itself
+ */
+void Scheduler_SetIdleHook(void (*hook)(uint32_t sleepMs));
+
+uint8_t Scheduler_GetTaskCount(void);
+
+/**
+ * @brief Statistics of the task at index (priority order)
+ */
+void Scheduler_GetTaskStats(uint8_t index, TaskStats_t *stats);
+
+#endif // SCHEDULER_H
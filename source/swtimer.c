@@ -0,0 +1,203 @@
+#include <stddef.h>
+#include "MKL25Z4.h"
+#include "fsl_common.h"
+#include "fsl_clock.h"
+#include "swtimer.h"
+#include "prof.h"
+
+#define SWTIMER_TICK_HZ     1000U
+#define SLOTS_PER_LEVEL     (1U << SWTIMER_SLOT_BITS)
+#define SLOT_MASK           (SLOTS_PER_LEVEL - 1U)
+
+// Slot lists (singly linked, pprev back-pointer for O(1) removal)
+static SwTimer_t *wheel[SWTIMER_LEVELS][SLOTS_PER_LEVEL];
+
+static uint32_t wheelBase = 0;      // Next tick to process
+static uint32_t armedCount = 0;
+
+static inline void SwTimer_TickStart(void)
+{
+    TPM2->CNT = 0;
+    TPM2->SC = TPM_SC_TOF_MASK | TPM_SC_TOIE_MASK | TPM_SC_CMOD(1);  // Clear flag, run
+}
+
+static inline void SwTimer_TickStop(void)
+{
+    TPM2->SC = TPM_SC_TOF_MASK;  // Stop counter, clear pending overflow
+}
+
+static void SwTimer_Link(SwTimer_t **head, SwTimer_t *timer)
+{
+    timer->next = *head;
+    if (timer->next != NULL) {
+        timer->next->pprev = &timer->next;
+    }
+    *head = timer;
+    timer->pprev = head;
+}
+
+static void SwTimer_Unlink(SwTimer_t *timer)
+{
+    *timer->pprev = timer->next;
+    if (timer->next != NULL) {
+        timer->next->pprev = timer->pprev;
+    }
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+/**
+ * @brief Put an armed timer into the slot for its expiry
+ * @note Interrupts masked
+ */
+static void SwTimer_Insert(SwTimer_t *timer)
+{
+    uint32_t delta = timer->expires - wheelBase;
+    uint32_t level = 0;
+    uint32_t slot;
+    
+    if ((int32_t)delta < 0) {
+        slot = wheelBase & SLOT_MASK;  // Already due: next tick
+    } else {
+        // Coarsest level needed: one per SWTIMER_SLOT_BITS of delta
+        while (level < SWTIMER_LEVELS - 1U && (delta >> (SWTIMER_SLOT_BITS * (level + 1U))) != 0) {
+            level++;
+        }
+        slot = (timer->expires >> (SWTIMER_SLOT_BITS * level)) & SLOT_MASK;
+    }
+    SwTimer_Link(&wheel[level][slot], timer);
+}
+
+/**
+ * @brief Move every timer of a coarse slot one level down
+ * @return The slot index (0 = the next level has to cascade too)
+ */
+static uint32_t SwTimer_Cascade(uint32_t level)
+{
+    uint32_t slot = (wheelBase >> (SWTIMER_SLOT_BITS * level)) & SLOT_MASK;
+    SwTimer_t *timer = wheel[level][slot];
+    
+    wheel[level][slot] = NULL;
+    while (timer != NULL) {
+        SwTimer_t *next = timer->next;
+        SwTimer_Insert(timer);
+        timer = next;
+    }
+    return slot;
+}
+
+/**
+ * @brief Process one tick: cascade, then fire the due slot
+ * @note Interrupt context
+ */
+static void SwTimer_Tick(void)
+{
+    uint32_t slot = wheelBase & SLOT_MASK;
+    
+    for (uint32_t level = 1; level < SWTIMER_LEVELS; level++) {
+        if ((wheelBase >> (SWTIMER_SLOT_BITS * (level - 1U))) & SLOT_MASK) {
+            break;
+        }
+        SwTimer_Cascade(level);
+    }
+    wheelBase++;
+    
+    // Detach the slot first: callbacks may start/stop timers in it
+    SwTimer_t *pending = wheel[0][slot];
+    wheel[0][slot] = NULL;
+    if (pending != NULL) {
+        pending->pprev = &pending;
+    }
+    
+    while (pending != NULL) {
+        SwTimer_t *timer = pending;
+        
+        SwTimer_Unlink(timer);
+        if (timer->periodMs != 0) {
+            timer->expires += timer->periodMs;
+            SwTimer_Insert(timer);
+        } else {
+            armedCount--;
+        }
+        timer->callback(timer->arg);
+    }
+    
+    if (armedCount == 0) {
+        SwTimer_TickStop();
+    }
+}
+
+void SwTimer_Init(void)
+{
+    SIM->SCGC6 |= SIM_SCGC6_TPM2_MASK;
+    
+    // TPM clock source = PLLFLLCLK (48MHz), same as the motor PWM
+    SIM->SOPT2 = (SIM->SOPT2 & ~SIM_SOPT2_TPMSRC_MASK) | SIM_SOPT2_TPMSRC(1);
+    
+    TPM2->SC = 0;
+    TPM2->MOD = CLOCK_GetFreq(kCLOCK_PllFllSelClk) / SWTIMER_TICK_HZ - 1U;
+    
+    NVIC_SetPriority(TPM2_IRQn, 2);
+    NVIC_EnableIRQ(TPM2_IRQn);
+}
+
+void SwTimer_Setup(SwTimer_t *timer, SwTimerCallback_t callback, void *arg)
+{
+    timer->next = NULL;
+    timer->pprev = NULL;
+    timer->callback = callback;
+    timer->arg = arg;
+}
+
+void SwTimer_Start(SwTimer_t *timer, uint32_t delayMs, uint32_t periodMs)
+{
+    if (delayMs == 0) {
+        delayMs = 1;
+    } else if (delayMs > SWTIMER_MAX_DELAY_MS) {
+        delayMs = SWTIMER_MAX_DELAY_MS;
+    }
+    if (periodMs > SWTIMER_MAX_DELAY_MS) {
+        periodMs = SWTIMER_MAX_DELAY_MS;
+    }
+    
+    uint32_t primask = DisableGlobalIRQ();
+    if (timer->pprev != NULL) {
+        SwTimer_Unlink(timer);
+    } else if (armedCount++ == 0) {
+        SwTimer_TickStart();
+    }
+    timer->expires = wheelBase + delayMs - 1U;
+    timer->periodMs = periodMs;
+    SwTimer_Insert(timer);
+    EnableGlobalIRQ(primask);
+}
+
+void SwTimer_Stop(SwTimer_t *timer)
+{
+    uint32_t primask = DisableGlobalIRQ();
+    if (timer->pprev != NULL) {
+        SwTimer_Unlink(timer);
+        if (--armedCount == 0) {
+            SwTimer_TickStop();
+        }
+    }
+    EnableGlobalIRQ(primask);
+}
+
+bool SwTimer_AnyActive(void)
+{
+    return armedCount != 0;
+}
+
+/**
+ * @brief TPM2 Interrupt Handler (wheel tick, 1ms)
+ */
+void TPM2_IRQHandler(void)
+{
+    PROF_START(entryUs);
+    
+    TPM2->SC |= TPM_SC_TOF_MASK;  // Write 1 to clear
+    SwTimer_Tick();
+    
+    PROF_END(PROF_ISR_TIMER, entryUs);
+}
@@ -0,0 +1,71 @@
+#ifndef SWTIMER_H
+#define SWTIMER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Software Timers (hierarchical timing wheel on one TPM2 1ms tick)
+ * 
+ * Any number of one-shot or periodic timers share one hardware timer.
+ * Timers live in caller-owned SwTimer_t structs (no allocation) and sit
+ * in a 4-level wheel of 32 slots each: start and stop are O(1), each tick
+ * runs only the slot that is due, and a timer is moved to a finer level
+ * at most three times on its way down (cascading).
+ * 
+ * Callbacks run in the TPM2 interrupt (priority 2): keep them short and
+ * hand work to the main loop (e.g. Events_Post(EVENT_SRC_TIMER, ...)).
+ * They may start or stop any timer, including their own.
+ * 
+ * Resolution is one tick: a timer fires between delayMs - 1 and delayMs
+ * after SwTimer_Start(). TPM2 only runs while a timer is armed.
+ */
+
+#define SWTIMER_LEVELS      4U
+#define SWTIMER_SLOT_BITS   5U
+#define SWTIMER_MAX_DELAY_MS ((1UL << (SWTIMER_LEVELS * SWTIMER_SLOT_BITS)) - 1U)  // ~17 min
+
+typedef void (*SwTimerCallback_t)(void *arg);
+
+typedef struct SwTimer {
+    struct SwTimer *next;
+    struct SwTimer **pprev;     // NULL while not armed
+    uint32_t expires;           // Tick the timer is due
+    uint32_t periodMs;          // 0 = one-shot
+    SwTimerCallback_t callback;
+    void *arg;
+} SwTimer_t;
+
+/**
+ * @brief Set up TPM2 as the wheel tick (stopped until a timer is armed)
+ */
+void SwTimer_Init(void);
+
+/**
+ * @brief Bind a callback to a timer (once, before the first start)
+ */
+void SwTimer_Setup(SwTimer_t *timer, SwTimerCallback_t callback, void *arg);
+
+/**
+ * @brief (Re)arm a timer
+ * @param delayMs  First expiry (1 .. SWTIMER_MAX_DELAY_MS)
+ * @param periodMs Re-arm interval after each expiry, 0 = one-shot
+ */
+void SwTimer_Start(SwTimer_t *timer, uint32_t delayMs, uint32_t periodMs);
+
+/**
+ * @brief Disarm a timer (no effect if it is not armed)
+ */
+void SwTimer_Stop(SwTimer_t *timer);
+
+static inline bool SwTimer_IsActive(const SwTimer_t *timer)
+{
+    return timer->pprev != 0;
+}
+
+/**
+ * @brief true while any timer is armed (the wheel needs its tick)
+ */
+bool SwTimer_AnyActive(void);
+
+#endif // SWTIMER_H
@@ -0,0 +1,42 @@
+#include "MKL25Z4.h"
+#include "tick.h"
+
+static volatile uint32_t tickMs = 0;
+static uint32_t carryUs = 0;    // Time asleep not yet a whole tick (< 1000)
+
+void Tick_Init(void)
+{
+    tickMs = 0;
+    SysTick_Config(SystemCoreClock / 1000U);
+}
+
+uint32_t Tick_GetMs(void)
+{
+    return tickMs;  // 32-bit aligned load is atomic on Cortex-M0+
+}
+
+void Tick_Suspend(void)
+{
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    
+    // The part of the current tick already counted down is restarted
+    // from zero on resume: keep it with the sleep time
+    uint32_t load = SysTick->LOAD;
+    carryUs += ((load - SysTick->VAL) * 1000U) / (load + 1U);
+}
+
+void Tick_Resume(uint32_t elapsedUs)
+{
+    uint32_t us = carryUs + elapsedUs;
+    uint32_t ms = us / 1000U;
+    
+    carryUs = us - ms * 1000U;  // Sub-ms remainder waits for the next sleep
+    tickMs += ms;               // SysTick is stopped, no race with the handler
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+}
+
+void SysTick_Handler(void)
+{
+    tickMs++;
+}
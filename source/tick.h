@@ -0,0 +1,37 @@
+#ifndef TICK_H
+#define TICK_H
+
+#include <stdint.h>
+
+/**
+ * System Tick (SysTick, 1ms)
+ * 
+ * Free-running millisecond counter used for event timestamps and task
+ * timing. Wraps after ~49 days; compare times with (int32_t)(a - b).
+ */
+
+/**
+ * @brief Start SysTick at 1kHz from the core clock
+ */
+void Tick_Init(void);
+
+/**
+ * @brief Milliseconds since Tick_Init()
+ */
+uint32_t Tick_GetMs(void);
+
+/**
+ * @brief Stop SysTick before a low-power mode (the core clock stops in Wait/VLPS)
+ */
+void Tick_Suspend(void);
+
+/**
+ * @brief Restart SysTick after a low-power mode
+ * @param elapsedUs Time spent asleep (measured by power.c). Whole ms go
+ *        to the counter, the rest (and the tick interrupted by
+ *        Tick_Suspend) carries over to the next resume, so repeated
+ *        sleeps do not drift
+ */
+void Tick_Resume(uint32_t elapsedUs);
+
+#endif // TICK_H
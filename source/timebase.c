@@ -0,0 +1,36 @@
+#include "timebase.h"
+#include "fsl_clock.h"
+
+void Timebase_Init(void)
+{
+    SIM->SCGC6 |= SIM_SCGC6_PIT_MASK;
+    PIT->MCR = 0;  // Enable PIT, do not freeze in debug
+    
+    PIT->CHANNEL[0].TCTRL = 0;
+    PIT->CHANNEL[1].TCTRL = 0;
+    
+    // PIT0: 1us period, only a prescaler for PIT1 (no interrupt)
+    PIT->CHANNEL[0].LDVAL = CLOCK_GetBusClkFreq() / 1000000U - 1U;
+    
+    // PIT1: decrements once per PIT0 expiry, full 32-bit range
+    PIT->CHANNEL[1].LDVAL = 0xFFFFFFFFU;
+    PIT->CHANNEL[1].TCTRL = PIT_TCTRL_CHN_MASK | PIT_TCTRL_TEN_MASK;
+    
+    PIT->CHANNEL[0].TCTRL = PIT_TCTRL_TEN_MASK;
+}
+
+void Timebase_DelayUs(uint32_t us)
+{
+    uint32_t start = Timebase_GetUs();
+    
+    while (Timebase_ElapsedUs(start) < us) {
+        // Busy wait on the hardware counter
+    }
+}
+
+void Timebase_DelayMs(uint32_t ms)
+{
+    while (ms--) {
+        Timebase_DelayUs(1000);
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <stdint.h>
+#include "MKL25Z4.h"
+
+/**
+ * Microsecond Timebase (PIT0 -> PIT1 chained)
+ * 
+ * PIT0 divides the 24MHz bus clock down to 1us, PIT1 is chained to it
+ * and counts microseconds down from 0xFFFFFFFF. Reading the clock is a
+ * single register load, safe from any context (also with interrupts
+ * masked) and needs no interrupt at all.
+ * 
+ * 32-bit, wraps after ~71 minutes: compare with (int32_t)(a - b) or use
+ * Timebase_ElapsedUs(). Runs in Wait, pauses in VLPS (bus clock off).
+ */
+
+/**
+ * @brief Start the chained PIT counters (call once, before any driver)
+ */
+void Timebase_Init(void);
+
+/**
+ * @brief Microseconds since Timebase_Init()
+ */
+static inline uint32_t Timebase_GetUs(void)
+{
+    return ~PIT->CHANNEL[1].CVAL;  // Down-counter from 0xFFFFFFFF
+}
+
+/**
+ * @brief Microseconds since startUs (wrap-safe)
+ */
+static inline uint32_t Timebase_ElapsedUs(uint32_t startUs)
+{
+    return Timebase_GetUs() - startUs;
+}
+
+/**
+ * @brief Busy-wait (interrupts may stay masked)
+ */
+void Timebase_DelayUs(uint32_t us);
+void Timebase_DelayMs(uint32_t ms);
+
+#endif // TIMEBASE_H
@@ -0,0 +1,92 @@
+#include "ttc.h"
+
+// Model from tools/brake_sim at 0, 10, ..., 100% (re-run it for other motors)
+static const uint8_t cruiseCmS[11] = {0, 0, 23, 38, 47, 53, 57, 61, 63, 65, 66};
+static const uint8_t brakeMm[11]   = {0, 0, 12, 24, 33, 38, 42, 45, 48, 49, 51};
+
+#define TTC_BRAKE_FACTOR    2U      // Model braking distance x this
+#define TTC_SMOOTH_SHIFT    2U      // Closing speed EMA: new = old + (sample - old) / 4
+#define TTC_MAX_DT_MS       200U    // Older previous sample: restart the speed estimate
+#define TTC_MAX_CLOSING_CM_S 200U   // Faster is a jump to a new target, not motion
+
+/**
+ * @brief Linear interpolation in a per-10% table
+ */
+static uint32_t Ttc_Lookup(const uint8_t *table, uint8_t speedPercent)
+{
+    if (speedPercent >= 100U) {
+        return table[10];
+    }
+    uint32_t i = speedPercent / 10U;
+    uint32_t frac = speedPercent % 10U;
+
+    return (table[i] * (10U - frac) + table[i + 1U] * frac) / 10U;
+}
+
+uint32_t Ttc_CruiseCmS(uint8_t speedPercent)
+{
+    return Ttc_Lookup(cruiseCmS, speedPercent);
+}
+
+uint32_t Ttc_StopDistanceCm(uint32_t closingCmS, uint32_t ageMs, uint8_t speedPercent)
+{
+    uint32_t brakeMmScaled = Ttc_Lookup(brakeMm, speedPercent) * TTC_BRAKE_FACTOR;
+    uint32_t cruise = Ttc_CruiseCmS(speedPercent);
+    uint32_t travelCm = (closingCmS * (ageMs + TTC_LOOKAHEAD_MS) + 999U) / 1000U;
+    uint32_t targetCm = 0;
+
+    // An obstacle coming closer keeps coming while the car brakes: at
+    // constant deceleration braking takes 2 * distance / speed. Up to 25%
+    // over cruise is the car itself (model error, speed estimate noise)
+    if (closingCmS > cruise + cruise / 4U && cruise > 0) {
+        targetCm = ((closingCmS - cruise) * 2U * brakeMmScaled / cruise + 9U) / 10U;
+    }
+
+    return (brakeMmScaled + 9U) / 10U + TTC_MARGIN_CM + travelCm + targetCm;
+}
+
+void Ttc_Reset(TtcTracker_t *tracker)
+{
+    tracker->lastCm = 0;
+    tracker->lastUs = 0;
+    tracker->closingQ4 = 0;
+    tracker->samples = 0;
+}
+
+bool Ttc_Update(TtcTracker_t *tracker, uint32_t distanceCm, uint32_t sampleUs, uint32_t nowUs,
+                uint8_t speedPercent)
+{
+    uint32_t dtMs = (sampleUs - tracker->lastUs) / 1000U;
+
+    if (tracker->samples > 0 && dtMs > 0 && dtMs <= TTC_MAX_DT_MS) {
+        // Closing speed from this sample and the previous one, cm/s Q4
+        int32_t deltaCm = (int32_t)tracker->lastCm - (int32_t)distanceCm;
+        int32_t sampleQ4 = (deltaCm * 16000) / (int32_t)dtMs;
+
+        if (tracker->samples == 1U) {
+            tracker->closingQ4 = sampleQ4;
+        } else {
+            tracker->closingQ4 += (sampleQ4 - tracker->closingQ4) / (1 << TTC_SMOOTH_SHIFT);
+        }
+        if (tracker->samples < 0xFFU) {
+            tracker->samples++;
+        }
+    } else {
+        tracker->samples = 1;  // First sample, or too old to difference against
+    }
+    tracker->lastCm = distanceCm;
+    tracker->lastUs = sampleUs;
+
+    // Never assume closing slower than the car drives
+    uint32_t closingCmS = Ttc_CruiseCmS(speedPercent);
+    if (tracker->samples > 1U && tracker->closingQ4 > (int32_t)(closingCmS * 16U)) {
+        closingCmS = (uint32_t)tracker->closingQ4 / 16U;
+    }
+    if (closingCmS > TTC_MAX_CLOSING_CM_S) {
+        closingCmS = TTC_MAX_CLOSING_CM_S;
+    }
+
+    uint32_t ageMs = (nowUs - sampleUs) / 1000U;
+
+    return distanceCm <= Ttc_StopDistanceCm(closingCmS, ageMs, speedPercent);
+}
@@ -0,0 +1,70 @@
+#ifndef TTC_H
+#define TTC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Time-to-Collision Obstacle Rule (no hardware access)
+ *
+ * Replaces the fixed "closer than 20cm" stop. From consecutive (filtered)
+ * distances the tracker estimates the closing speed, projects the
+ * distance forward to when the next reading could act on it, and stops
+ * when that is inside the braking distance for the current speed setting
+ * plus a margin:
+ *
+ *   d - v * (age + TTC_LOOKAHEAD_MS)  <=  brake(speed) * 2 + TTC_MARGIN_CM
+ *
+ * v is the larger of the measured closing speed and the car's own
+ * cruise speed at that setting (a receding target only makes the stop a
+ * little early; a noisy low estimate never makes it late). Cruise speeds
+ * and braking distances come from tools/brake_sim (brake + coast); the
+ * factor 2 covers floors and batteries the model does not.
+ *
+ * An obstacle closing more than 25% faster than the car drives is moving
+ * towards it and keeps coming while the car brakes; that is added too.
+ *
+ * At 20% the car now drives to ~12cm of a wall instead of 17cm; at 100%,
+ * and with the obstacle coming towards the car, it stops earlier than the
+ * fixed 20cm did (tools/ttc_sim). Plain C so tools/ can run the same rule
+ * in the simulator.
+ */
+
+#define TTC_MARGIN_CM       5U      // Gap to keep after braking
+#define TTC_LOOKAHEAD_MS    60U     // Next ranging result (50ms) + obstacle task (10ms)
+
+typedef struct {
+    uint32_t lastCm;        // Previous distance
+    uint32_t lastUs;        // Its sample time
+    int32_t closingQ4;      // Measured closing speed, cm/s Q4 (+ = nearer), smoothed
+    uint8_t samples;        // Distances seen since the reset (saturates)
+} TtcTracker_t;
+
+/**
+ * @brief Forget the history (new direction, lost target)
+ */
+void Ttc_Reset(TtcTracker_t *tracker);
+
+/**
+ * @brief Feed one distance sample and decide
+ * @param distanceCm Filtered distance
+ * @param sampleUs When it was measured (Timebase_GetUs)
+ * @param nowUs Current time (Timebase_GetUs)
+ * @param speedPercent Speed setting (FSM_GetSpeed)
+ * @return true if the car must stop now
+ */
+bool Ttc_Update(TtcTracker_t *tracker, uint32_t distanceCm, uint32_t sampleUs, uint32_t nowUs,
+                uint8_t speedPercent);
+
+/**
+ * @brief Distance under which Ttc_Update() stops for a closing speed
+ *        (cm/s) and age, exposed for the simulator and telemetry
+ */
+uint32_t Ttc_StopDistanceCm(uint32_t closingCmS, uint32_t ageMs, uint8_t speedPercent);
+
+/**
+ * @brief Cruise speed of the car at a speed setting, cm/s (model)
+ */
+uint32_t Ttc_CruiseCmS(uint8_t speedPercent);
+
+#endif // TTC_H
@@ -1,46 +1,359 @@
 #include "MKL25Z4.h"
+#include "fsl_common.h"
+#include "fsl_dma.h"
+#include "fsl_dmamux.h"
+#include "fsl_lpsci_dma.h"
 #include "uart.h"
+#include "fmt.h"
 
-// Wait for transmission to complete
-static void UART_WaitComplete(void)
+/**
+ * Non-blocking UART0 TX
+ *
+ * At 9600 baud one byte takes ~1ms on the wire, so spinning on TDRE for
+ * every byte stalls the main loop for the whole message. Two backends:
+ *
+ * UART_TX_USE_DMA = 1 (default): double-buffered frames sent with
+ *   LPSCI_TransferSendDMA(). UART_Send* append to the fill frame while DMA
+ *   streams the other one; the DMA completion callback swaps them. The CPU
+ *   cost per byte is one memory copy.
+ *
+ * UART_TX_USE_DMA = 0: the bytes are queued in a ring buffer and the TDRE
+ *   interrupt feeds UART0->D. TIE is only enabled while there is
+ *   something to send.
+ */
+#define UART_TX_USE_DMA     1
+
+// DMA channel used for UART0 TX
+#define UART_TX_DMA_CHANNEL 0U
+
+// DMA frames (two of them: one filling, one on the wire). One frame must
+// hold a whole sensor report ('I', ~400 bytes verbose) under UART_TX_DROP
+#define TX_FRAME_SIZE   512U
+
+// TX ring buffer for the interrupt backend (size must be a power of two)
+#define TX_BUFFER_SIZE  512U
+#define TX_BUFFER_MASK  (TX_BUFFER_SIZE - 1U)
+
+static volatile uint32_t txDropped = 0;
+static UART_TxPolicy_t txPolicy = UART_TX_BLOCK;
+static bool txReady = false;  // false until UART_TxInit() -> polled TX
+
+// Send one byte straight to the data register (no interrupts needed)
+static void UART_TxPollByte(uint8_t byte)
+{
+    while (!(UART0->S1 & UART_S1_TDRE_MASK));
+    UART0->D = byte;
+}
+
+#if UART_TX_USE_DMA
+
+static uint8_t txFrame[2][TX_FRAME_SIZE];
+static volatile uint8_t txFill = 0;       // Frame the CPU is writing into
+static volatile uint16_t txFillLen = 0;   // Bytes waiting in the fill frame
+static volatile bool txDmaBusy = false;   // Other frame is on the wire
+
+static dma_handle_t txDmaHandle;
+static lpsci_dma_handle_t lpsciDmaHandle;
+
+/**
+ * @brief Hand the fill frame to DMA and start filling the other one
+ * @note Caller must have interrupts masked
+ */
+static void UART_TxStartFrame(void)
 {
-    // Wait for Transmission Complete flag
+    lpsci_transfer_t xfer;
+
+    xfer.data = txFrame[txFill];
+    xfer.dataSize = txFillLen;
+
+    txFill ^= 1U;
+    txFillLen = 0;
+    txDmaBusy = true;
+
+    LPSCI_TransferSendDMA(UART0, &lpsciDmaHandle, &xfer);
+}
+
+/**
+ * @brief DMA finished a frame (DMA0 interrupt context)
+ */
+static void UART_TxDmaCallback(UART0_Type *base, lpsci_dma_handle_t *handle, status_t status, void *userData)
+{
+    txDmaBusy = false;
+
+    if (txFillLen > 0) {
+        UART_TxStartFrame();
+    }
+}
+
+// Start DMA if it is idle and there is something to send
+static inline void UART_TxKick(void)
+{
+    uint32_t primask = DisableGlobalIRQ();
+    if (!txDmaBusy && txFillLen > 0) {
+        UART_TxStartFrame();
+    }
+    EnableGlobalIRQ(primask);
+}
+
+// With interrupts masked the completion ISR cannot run - service it here
+static void UART_TxPollComplete(void)
+{
+    if (txDmaBusy && (DMA_GetChannelStatusFlags(DMA0, UART_TX_DMA_CHANNEL) & kDMA_TransactionsDoneFlag)) {
+        DMA_HandleIRQ(&txDmaHandle);
+    }
+}
+
+/**
+ * @brief Queue a block of bytes, honouring the TX policy
+ */
+static void UART_TxWrite(const uint8_t *data, uint32_t len)
+{
+    if (!txReady) {
+        while (len--) {
+            UART_TxPollByte(*data++);
+        }
+        return;
+    }
+
+    if (txPolicy == UART_TX_DROP && (TX_FRAME_SIZE - txFillLen) < len) {
+        UART_TxKick();  // Frees the fill frame if DMA was idle
+        if ((TX_FRAME_SIZE - txFillLen) < len) {
+            txDropped += len;  // Drop the whole message, never a partial line
+            return;
+        }
+    }
+
+    while (len > 0) {
+        uint32_t primask = DisableGlobalIRQ();
+        uint16_t space = TX_FRAME_SIZE - txFillLen;
+        uint8_t *dst = &txFrame[txFill][txFillLen];
+        uint16_t n = (len < space) ? (uint16_t)len : space;
+
+        // The DMA callback may swap frames, so copy with interrupts masked
+        for (uint16_t i = 0; i < n; i++) {
+            dst[i] = data[i];
+        }
+        txFillLen += n;
+        EnableGlobalIRQ(primask);
+
+        data += n;
+        len -= n;
+
+        UART_TxKick();
+        if (len > 0) {
+            // Fill frame is full: wait until the completion callback hands
+            // it to DMA (txFillLen back to 0), not for that frame to finish
+            while (txFillLen >= TX_FRAME_SIZE) {
+                if (__get_PRIMASK()) {
+                    UART_TxPollComplete();
+                }
+            }
+        }
+    }
+}
+
+void UART_TxInit(void)
+{
+    txFill = 0;
+    txFillLen = 0;
+    txDmaBusy = false;
+    txDropped = 0;
+
+    DMAMUX_Init(DMAMUX0);
+    DMAMUX_SetSource(DMAMUX0, UART_TX_DMA_CHANNEL, kDmaRequestMux0UART0Tx);
+    DMAMUX_EnableChannel(DMAMUX0, UART_TX_DMA_CHANNEL);
+
+    DMA_Init(DMA0);
+    DMA_CreateHandle(&txDmaHandle, DMA0, UART_TX_DMA_CHANNEL);
+    LPSCI_TransferCreateHandleDMA(UART0, &lpsciDmaHandle, UART_TxDmaCallback, NULL, &txDmaHandle, NULL);
+
+    NVIC_SetPriority(DMA0_IRQn, 2);
+    NVIC_SetPriority(UART0_IRQn, 2);
+    NVIC_EnableIRQ(UART0_IRQn);
+
+    txReady = true;
+}
+
+void UART_TxIRQHandler(void)
+{
+    // TDRE raises DMA requests (C5[TDMAE]), nothing to do here
+}
+
+void UART_Flush(void)
+{
+    UART_TxKick();
+    while (txDmaBusy || txFillLen > 0) {
+        if (__get_PRIMASK()) {
+            UART_TxPollComplete();
+        }
+        UART_TxKick();
+    }
+    // Wait for the last byte to leave the shift register
     while (!(UART0->S1 & UART_S1_TC_MASK));
 }
 
-// UART helper functions
-void UART_SendByte(uint8_t byte)
+bool UART_TxIdle(void)
 {
-    while (!(UART0->S1 & UART_S1_TDRE_MASK));
-    UART0->D = byte;
+    return !txDmaBusy && txFillLen == 0 && (UART0->S1 & UART_S1_TC_MASK);
 }
 
-void UART_SendString(const char* str)
+#else
+
+static uint8_t txBuffer[TX_BUFFER_SIZE];
+static volatile uint16_t txHead = 0;  // Free-running write index (main loop)
+static volatile uint16_t txTail = 0;  // Free-running read index (ISR)
+
+static inline uint16_t UART_TxCount(void)
+{
+    return (uint16_t)(txHead - txTail);
+}
+
+// Start (or keep) the TDRE interrupt running
+static inline void UART_TxKick(void)
 {
-    while (*str) {
-        UART_SendByte(*str++);
+    uint32_t primask = DisableGlobalIRQ();
+    UART0->C2 |= UART_C2_TIE_MASK;
+    EnableGlobalIRQ(primask);
+}
+
+// Move one queued byte out by polling - used when the ISR cannot run
+static void UART_TxPollDrainOne(void)
+{
+    if (txTail != txHead) {
+        UART_TxPollByte(txBuffer[txTail & TX_BUFFER_MASK]);
+        txTail++;
     }
-    UART_WaitComplete();  // Wait for all bytes to be sent
 }
 
-void UART_SendNumber(uint32_t num)
+/**
+ * @brief Queue a block of bytes, honouring the TX policy
+ */
+static void UART_TxWrite(const uint8_t *data, uint32_t len)
 {
-    char buffer[12];
-    int i = 0;
+    if (!txReady) {
+        while (len--) {
+            UART_TxPollByte(*data++);
+        }
+        return;
+    }
 
-    if (num == 0) {
-        UART_SendByte('0');
-        UART_WaitComplete();
+    if (txPolicy == UART_TX_DROP && (TX_BUFFER_SIZE - UART_TxCount()) < len) {
+        txDropped += len;  // Drop the whole message, never a partial line
         return;
     }
 
-    while (num > 0) {
-        buffer[i++] = '0' + (num % 10);
-        num /= 10;
+    while (len > 0) {
+        uint16_t space = TX_BUFFER_SIZE - UART_TxCount();
+
+        if (space == 0) {
+            if (__get_PRIMASK()) {
+                UART_TxPollDrainOne();  // Interrupts masked: make room ourselves
+            }
+            continue;
+        }
+
+        while (space > 0 && len > 0) {
+            txBuffer[txHead & TX_BUFFER_MASK] = *data++;
+            txHead++;
+            space--;
+            len--;
+        }
+        UART_TxKick();
+    }
+}
+
+void UART_TxInit(void)
+{
+    txHead = 0;
+    txTail = 0;
+    txDropped = 0;
+    txReady = true;
+
+    NVIC_SetPriority(UART0_IRQn, 2);
+    NVIC_EnableIRQ(UART0_IRQn);
+}
+
+void UART_TxIRQHandler(void)
+{
+    if ((UART0->C2 & UART_C2_TIE_MASK) && (UART0->S1 & UART_S1_TDRE_MASK)) {
+        if (txTail != txHead) {
+            UART0->D = txBuffer[txTail & TX_BUFFER_MASK];
+            txTail++;
+        } else {
+            UART0->C2 &= ~UART_C2_TIE_MASK;  // Nothing left: stop TDRE interrupts
+        }
+    }
+}
+
+void UART_Flush(void)
+{
+    while (txTail != txHead) {
+        if (__get_PRIMASK()) {
+            UART_TxPollDrainOne();
+        }
     }
+    // Wait for the last byte to leave the shift register
+    while (!(UART0->S1 & UART_S1_TC_MASK));
+}
+
+bool UART_TxIdle(void)
+{
+    return (txTail == txHead) && (UART0->S1 & UART_S1_TC_MASK);
+}
+
+#endif /* UART_TX_USE_DMA */
 
-    while (i > 0) {
-        UART_SendByte(buffer[--i]);
+// UART helper functions
+void UART_SendByte(uint8_t byte)
+{
+    UART_TxWrite(&byte, 1);
+}
+
+void UART_SendString(const char* str)
+{
+    uint32_t len = 0;
+
+    while (str[len]) {
+        len++;
     }
-    UART_WaitComplete();  // Wait for all bytes to be sent
+    UART_TxWrite((const uint8_t *)str, len);
+}
+
+void UART_SendBuffer(const uint8_t *data, uint32_t len)
+{
+    UART_TxWrite(data, len);
+}
+
+void UART_SendNumber(uint32_t num)
+{
+    char buffer[FMT_U32_MAX_LEN];
+    uint8_t len = Fmt_U32(buffer, num);
+
+    UART_TxWrite((const uint8_t *)buffer, len);
+}
+
+void UART_SendCenti(uint32_t centi)
+{
+    char buffer[FMT_CENTI_MAX_LEN];
+    uint8_t len = Fmt_Centi(buffer, centi);
+
+    UART_TxWrite((const uint8_t *)buffer, len);
+}
+
+void UART_SendHex(uint32_t value, uint8_t minDigits)
+{
+    char buffer[FMT_HEX32_MAX_LEN];
+    uint8_t len = Fmt_Hex32(buffer, value, minDigits);
+
+    UART_TxWrite((const uint8_t *)buffer, len);
+}
+
+void UART_SetTxPolicy(UART_TxPolicy_t policy)
+{
+    txPolicy = policy;
+}
+
+uint32_t UART_GetTxDropped(void)
+{
+    return txDropped;
 }
@@ -2,9 +2,77 @@
 #define UART_H
 
 #include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Non-blocking UART0 TX
+ *
+ * UART_Send* copy the data into a TX buffer and return immediately; the
+ * backend is chosen by UART_TX_USE_DMA in uart.c:
+ *   1 (default): two 512-byte frames (TX_FRAME_SIZE). UART_Send* fill one
+ *       while DMA sends the other; the DMA completion swaps them.
+ *   0: a 512-byte ring buffer drained by the UART0 TDRE interrupt.
+ *
+ * Under UART_TX_DROP a message is queued whole or not at all, so one
+ * longer than the buffer (512 bytes) is always dropped - send long
+ * reports in pieces, or under UART_TX_BLOCK.
+ */
+
+// What UART_Send* do when the TX buffer cannot hold the whole message
+typedef enum {
+    UART_TX_BLOCK = 0,  // Wait for the DMA / ISR to make room (never loses data)
+    UART_TX_DROP        // Drop the whole message and count it
+} UART_TxPolicy_t;
+
+/**
+ * @brief Enable the DMA / interrupt-driven TX path
+ * @note Call after BOARD_InitDebugConsole(). Before this, UART_Send* poll.
+ */
+void UART_TxInit(void);
 
 void UART_SendByte(uint8_t byte);
 void UART_SendString(const char *str);
 void UART_SendNumber(uint32_t num);
 
+/**
+ * @brief Send a block of bytes as one message (all or nothing under UART_TX_DROP)
+ */
+void UART_SendBuffer(const uint8_t *data, uint32_t len);
+
+/**
+ * @brief Send a centi-unit value as "whole.ff" (e.g. DHT11 2305 -> "23.05")
+ */
+void UART_SendCenti(uint32_t centi);
+
+/**
+ * @brief Send uppercase hex, zero-padded to minDigits
+ */
+void UART_SendHex(uint32_t value, uint8_t minDigits);
+
+/**
+ * @brief Block until every queued byte has left the shift register
+ */
+void UART_Flush(void);
+
+/**
+ * @brief true when nothing is queued or on the wire (safe to stop the UART clock)
+ */
+bool UART_TxIdle(void);
+
+/**
+ * @brief Select what happens when the TX buffer is full
+ */
+void UART_SetTxPolicy(UART_TxPolicy_t policy);
+
+/**
+ * @brief Number of bytes dropped because the TX buffer was full
+ */
+uint32_t UART_GetTxDropped(void);
+
+/**
+ * @brief TX half of the UART0 interrupt
+ * @note Called from UART0_IRQHandler (bluetooth.c)
+ */
+void UART_TxIRQHandler(void);
+
 #endif
@@ -2,8 +2,12 @@
 #include "fsl_gpio.h"
 #include "fsl_port.h"
 #include "fsl_clock.h"
+#include "fsl_dma.h"
+#include "fsl_dmamux.h"
 #include "MKL25Z4.h"
 #include "uart.h"
+#include "timebase.h"
+#include "range_filter.h"
 
 /**
  * Dual HC-SR04 Ultrasonic Distance Sensors
@@ -16,8 +20,38 @@
  * 5. Distance = (ECHO pulse duration in µs) / 58
  * 
  * TIMING IMPLEMENTATION:
- * Uses TPM2 as a free-running counter for precise timing.
- * TPM2 config: 48MHz / 32 (prescaler) = 1.5MHz = 0.667µs per tick
+ * Each ECHO pin is a TPM input capture channel set for both edges, with
+ * its DMA request enabled instead of the channel interrupt. On every edge
+ * the DMA copies the microsecond timebase (PIT1 CVAL) into edges[], so
+ * both timestamps are taken by hardware within a bus cycle or two of the
+ * edge - the TPM counters themselves wrap every 1ms (TPM0, motor PWM) and
+ * cannot time a 23ms echo. After the second edge the DMA completion
+ * interrupt marks that sensor done; once both are, the pair becomes one
+ * reading. The CPU only sends the trigger (~12µs) and does the arithmetic.
+ * 
+ * Both sensors fire together (shared TRIG), so each can hear the other's
+ * burst. An echo is only accepted if:
+ * - ECHO rose ECHO_RISE_MIN_US..ECHO_RISE_MAX_US after the trigger
+ *   (otherwise the edges are not from this ping: NO_ECHO)
+ * - it did not end within CROSSTALK_WINDOW_US of the other sensor's echo
+ *   while jumping away from its own previous reading. One wavefront at
+ *   both sensors that close together is one sensor's echo heard by the
+ *   other around the chassis (CROSSTALK). When it cannot tell which (both
+ *   jumped, both steady, no previous reading) both are kept: a spurious
+ *   near reading only stops the car, a missed one hits the wall.
+ * 
+ * Background ranging: the TPM1 counter (already running for the rear
+ * capture) overflows every ULTRASONIC_RANGING_PERIOD_MS and its interrupt
+ * starts the next ping. Each finished pair is copied to the snapshot
+ * under a sequence counter that is odd while the copy is written; readers
+ * copy it and retry if the counter was odd or moved. The writer is always
+ * a priority 2 ISR (or the main loop with interrupts masked), so a main
+ * loop reader retries at most once per reading and never blocks it.
+ * TPM1 stops in VLPS, and so does the ranging.
+ * 
+ * No completion within ULTRASONIC_PING_TIMEOUT_US (no sensor, echo never
+ * started) is noticed lazily by the next Ultrasonic_GetLatest() /
+ * Ultrasonic_StartMeasurement() and reported as NO_ECHO.
  */
 
 // Shared TRIG pin (PTC8)
@@ -25,121 +59,293 @@
 #define ULTRASONIC_TRIG_PORT    PORTC
 #define ULTRASONIC_TRIG_PIN     8U          // PTC8 (J1)
 
-// FRONT sensor ECHO pin (PTC9)
+// FRONT sensor ECHO pin (PTC9 = TPM0_CH5)
 #define ULTRASONIC_ECHO_FRONT_GPIO    GPIOC
 #define ULTRASONIC_ECHO_FRONT_PORT    PORTC
 #define ULTRASONIC_ECHO_FRONT_PIN     9U    // PTC9 (J1)
+#define ULTRASONIC_ECHO_FRONT_TPM     TPM0
+#define ULTRASONIC_ECHO_FRONT_CH      5U
+#define ULTRASONIC_FRONT_DMA_CHANNEL  2U
 
-// REAR sensor ECHO pin (PTA12)
+// REAR sensor ECHO pin (PTA12 = TPM1_CH0)
 #define ULTRASONIC_ECHO_REAR_GPIO     GPIOA
 #define ULTRASONIC_ECHO_REAR_PORT     PORTA
 #define ULTRASONIC_ECHO_REAR_PIN      12U   // PTA12
+#define ULTRASONIC_ECHO_REAR_TPM      TPM1
+#define ULTRASONIC_ECHO_REAR_CH       0U
+#define ULTRASONIC_REAR_DMA_CHANNEL   3U
+
+// Give up on a measurement after this long: the 400cm maximum range is
+// 23.2ms, an HC-SR04 without an echo drops ECHO after ~38ms
+#define ULTRASONIC_PING_TIMEOUT_US    40000U
+// Blocking calls: wait this long for ECHO to drop before triggering
+#define SHORT_TIMEOUT_US        10000U
+
+// TPM1: 48MHz / 128 -> 375kHz, overflow every ULTRASONIC_RANGING_PERIOD_MS
+#define RANGING_TPM_PS          7U
+
+// HC-SR04 raises ECHO ~0.5ms after the trigger (8 bursts sent)
+#define ECHO_RISE_MIN_US        100U
+#define ECHO_RISE_MAX_US        3000U
+// Echo ends this close together: one wavefront (~20cm of chassis at 343m/s)
+#define CROSSTALK_WINDOW_US     600U
+// Change from the previous reading still counted as steady (~10cm per ping)
+#define STEADY_DELTA_US         600U
 
-// Timer configuration (TPM2 @ 48MHz with prescaler 32 = 1.5MHz)
-#define TPM2_PRESCALER          5U          // PS=5 means divide by 32
-#define TPM2_FREQ_HZ            1500000U    // 48MHz / 32 = 1.5MHz
-#define TICKS_PER_US_NUM        3U          // 1.5 ticks per µs (numerator)
-#define TICKS_PER_US_DEN        2U          // 1.5 ticks per µs (denominator)
+typedef struct {
+    GPIO_Type *echoGpio;
+    uint32_t echoPin;
+    TPM_Type *tpm;
+    uint32_t tpmChannel;
+    uint32_t dmaChannel;
+} UltrasonicHw_t;
 
-// Timeout: 30ms = 30000µs * 1.5 = 45000 ticks
-#define TIMEOUT_TICKS           45000U
-// For shorter waits (e.g., waiting for ECHO to go HIGH after TRIG)
-#define SHORT_TIMEOUT_TICKS     15000U      // ~10ms
+typedef struct {
+    uint32_t edges[2];              // Raw PIT1 CVAL at rising / falling edge (DMA)
+    volatile bool done;             // Both edges captured
+    uint32_t lastPulseUs;           // Last accepted pulse (crosstalk check), 0 = none
+} UltrasonicChannel_t;
+
+static const UltrasonicHw_t sensorHw[ULTRASONIC_SENSOR_COUNT] = {
+    [ULTRASONIC_FRONT] = {ULTRASONIC_ECHO_FRONT_GPIO, ULTRASONIC_ECHO_FRONT_PIN, ULTRASONIC_ECHO_FRONT_TPM,
+                          ULTRASONIC_ECHO_FRONT_CH, ULTRASONIC_FRONT_DMA_CHANNEL},
+    [ULTRASONIC_REAR]  = {ULTRASONIC_ECHO_REAR_GPIO, ULTRASONIC_ECHO_REAR_PIN, ULTRASONIC_ECHO_REAR_TPM,
+                          ULTRASONIC_ECHO_REAR_CH, ULTRASONIC_REAR_DMA_CHANNEL},
+};
+
+static UltrasonicChannel_t sensors[ULTRASONIC_SENSOR_COUNT];
+
+static volatile bool pingBusy = false;      // Trigger sent, not all echoes in
+static uint32_t triggerUs;
+static UltrasonicReading_t latest;          // Written with interrupts masked or in the DMA ISRs
+static uint32_t readSequence;               // latest.sequence at the last Ultrasonic_GetLatest()
+
+static RangeFilter_t filters[ULTRASONIC_SENSOR_COUNT];  // Snapshot distances
+static uint32_t lastTriggerUs;              // Filter time step
+static DistanceSnapshot_t snapshot;
+static volatile uint32_t snapshotSeq = 0;   // Odd while snapshot is being written
 
 /**
- * @brief Read the current TPM2 counter value
+ * @brief Read ECHO pin state for specified sensor
+ * @note PDIR follows the pin for any digital mux, also the TPM one
  */
-static inline uint16_t Ultrasonic_GetTicks(void)
+static inline uint8_t Ultrasonic_ReadEcho(UltrasonicSensor_t sensor)
 {
-    return (uint16_t)(TPM2->CNT & 0xFFFF);
+    return (sensorHw[sensor].echoGpio->PDIR & (1U << sensorHw[sensor].echoPin)) ? 1 : 0;
 }
 
 /**
- * @brief Calculate elapsed ticks handling 16-bit overflow
+ * @brief Set TRIG pin state (shared for both sensors)
  */
-static inline uint16_t Ultrasonic_ElapsedTicks(uint16_t start, uint16_t end)
+static inline void Ultrasonic_SetTrig(uint8_t value)
 {
-    return (uint16_t)(end - start);
+    if (value) {
+        ULTRASONIC_TRIG_GPIO->PSOR = (1U << ULTRASONIC_TRIG_PIN);
+    } else {
+        ULTRASONIC_TRIG_GPIO->PCOR = (1U << ULTRASONIC_TRIG_PIN);
+    }
 }
 
 /**
- * @brief Convert ticks to microseconds
+ * @brief Pulse width to distance, clamped to the reliable range
  */
-static inline uint32_t Ultrasonic_TicksToUs(uint16_t ticks)
+static uint32_t Ultrasonic_PulseToCm(uint32_t pulseUs)
 {
-    return ((uint32_t)ticks * TICKS_PER_US_DEN) / TICKS_PER_US_NUM;
+    if (pulseUs == 0) {
+        return ULTRASONIC_TIMEOUT_CM;
+    }
+    
+    uint32_t distanceCm = pulseUs / 58;
+    
+    if (distanceCm < ULTRASONIC_MIN_DISTANCE_CM) {
+        return ULTRASONIC_MIN_DISTANCE_CM;
+    }
+    if (distanceCm > ULTRASONIC_MAX_DISTANCE_CM) {
+        return ULTRASONIC_TIMEOUT_CM;
+    }
+    
+    return distanceCm;
 }
 
-/**
- * @brief Convert microseconds to ticks
- */
-static inline uint16_t Ultrasonic_UsToTicks(uint32_t us)
+static inline uint32_t Ultrasonic_AbsDiff(uint32_t a, uint32_t b)
 {
-    uint32_t ticks = (us * TICKS_PER_US_NUM) / TICKS_PER_US_DEN;
-    if (ticks > 0xFFFF) ticks = 0xFFFF;
-    return (uint16_t)ticks;
+    return (a > b) ? a - b : b - a;
 }
 
 /**
- * @brief Microsecond delay using TPM2 hardware timer
+ * @brief One sensor's echo from its captured edges
+ * @param fallUs Set to the falling edge time
  */
-static void Ultrasonic_DelayUs(uint32_t us)
+static void Ultrasonic_Evaluate(UltrasonicSensor_t sensor, UltrasonicEcho_t *echo, uint32_t *fallUs)
 {
-    uint16_t startTicks = Ultrasonic_GetTicks();
-    uint16_t delayTicks = Ultrasonic_UsToTicks(us);
+    const UltrasonicChannel_t *ch = &sensors[sensor];
+    uint32_t riseUs = ~ch->edges[0];  // PIT1 counts down, like Timebase_GetUs()
+    uint32_t riseDelay = riseUs - triggerUs;
+    
+    *fallUs = ~ch->edges[1];
+    echo->pulseUs = 0;
+    echo->distanceCm = ULTRASONIC_TIMEOUT_CM;
+    echo->status = ULTRASONIC_NO_ECHO;
     
-    while (Ultrasonic_ElapsedTicks(startTicks, Ultrasonic_GetTicks()) < delayTicks) {
-        // Busy wait using hardware timer
+    if (!ch->done || riseDelay < ECHO_RISE_MIN_US || riseDelay > ECHO_RISE_MAX_US) {
+        return;
+    }
+    
+    uint32_t pulseUs = *fallUs - riseUs;
+    uint32_t distanceCm = Ultrasonic_PulseToCm(pulseUs);
+    
+    if (distanceCm != ULTRASONIC_TIMEOUT_CM) {
+        echo->pulseUs = pulseUs;
+        echo->distanceCm = distanceCm;
+        echo->status = ULTRASONIC_OK;
     }
 }
 
 /**
- * @brief Read ECHO pin state for specified sensor
+ * @brief Echo jumped away from the sensor's previous reading
  */
-static inline uint8_t Ultrasonic_ReadEcho(UltrasonicSensor_t sensor)
+static inline bool Ultrasonic_Jumped(UltrasonicSensor_t sensor, const UltrasonicEcho_t *echo)
 {
-    if (sensor == ULTRASONIC_FRONT) {
-        return (ULTRASONIC_ECHO_FRONT_GPIO->PDIR & (1U << ULTRASONIC_ECHO_FRONT_PIN)) ? 1 : 0;
-    } else {
-        return (ULTRASONIC_ECHO_REAR_GPIO->PDIR & (1U << ULTRASONIC_ECHO_REAR_PIN)) ? 1 : 0;
-    }
+    uint32_t last = sensors[sensor].lastPulseUs;
+    
+    return last == 0 || Ultrasonic_AbsDiff(echo->pulseUs, last) > STEADY_DELTA_US;
 }
 
 /**
- * @brief Set TRIG pin state (shared for both sensors)
+ * @brief Filter latest and copy it to the snapshot (seqlock write side)
+ * @note Caller must have interrupts masked (or be a DMA ISR)
  */
-static inline void Ultrasonic_SetTrig(uint8_t value)
+static void Ultrasonic_PublishSnapshot(void)
 {
-    if (value) {
-        ULTRASONIC_TRIG_GPIO->PSOR = (1U << ULTRASONIC_TRIG_PIN);
-    } else {
-        ULTRASONIC_TRIG_GPIO->PCOR = (1U << ULTRASONIC_TRIG_PIN);
+    uint32_t dtMs = (latest.sequence > 1U) ? (latest.timeUs - lastTriggerUs) / 1000U : 0U;
+    
+    lastTriggerUs = latest.timeUs;
+    for (uint32_t i = 0; i < ULTRASONIC_SENSOR_COUNT; i++) {
+        const UltrasonicEcho_t *echo = &latest.echo[i];
+        RangeFilter_Update(&filters[i], echo->distanceCm, echo->status == ULTRASONIC_OK, dtMs);
     }
+    
+    snapshotSeq++;  // Odd: readers retry
+    __DMB();
+    snapshot.timeUs = latest.timeUs;
+    snapshot.sequence = latest.sequence;
+    snapshot.valid = 0;
+    for (uint32_t i = 0; i < ULTRASONIC_SENSOR_COUNT; i++) {
+        if (RangeFilter_Valid(&filters[i])) {
+            snapshot.valid |= ULTRASONIC_VALID(i);
+        }
+    }
+    snapshot.frontCm = (snapshot.valid & ULTRASONIC_VALID(ULTRASONIC_FRONT)) ?
+                       filters[ULTRASONIC_FRONT].estimateCm : ULTRASONIC_TIMEOUT_CM;
+    snapshot.rearCm = (snapshot.valid & ULTRASONIC_VALID(ULTRASONIC_REAR)) ?
+                      filters[ULTRASONIC_REAR].estimateCm : ULTRASONIC_TIMEOUT_CM;
+    snapshot.frontConfidence = filters[ULTRASONIC_FRONT].confidence;
+    snapshot.rearConfidence = filters[ULTRASONIC_REAR].confidence;
+    __DMB();
+    snapshotSeq++;  // Even: consistent again
 }
 
 /**
- * @brief Initialize TPM2 as free-running counter for timing
+ * @brief All echoes in (or timed out): stop the DMA, publish the pair
+ * @note Caller must have interrupts masked (or be a DMA ISR)
  */
-static void Ultrasonic_InitTimer(void)
+static void Ultrasonic_Finish(void)
 {
-    // Enable TPM2 clock gate
-    SIM->SCGC6 |= SIM_SCGC6_TPM2_MASK;
+    UltrasonicEcho_t *front = &latest.echo[ULTRASONIC_FRONT];
+    UltrasonicEcho_t *rear = &latest.echo[ULTRASONIC_REAR];
+    uint32_t fallUs[ULTRASONIC_SENSOR_COUNT];
     
-    // TPM clock source
-    SIM->SOPT2 = (SIM->SOPT2 & ~SIM_SOPT2_TPMSRC_MASK) | SIM_SOPT2_TPMSRC(1);
+    for (uint32_t i = 0; i < ULTRASONIC_SENSOR_COUNT; i++) {
+        DMA_DisableChannelRequest(DMA0, sensorHw[i].dmaChannel);
+        DMA_ClearChannelStatusFlags(DMA0, sensorHw[i].dmaChannel, kDMA_TransactionsDoneFlag);
+        Ultrasonic_Evaluate((UltrasonicSensor_t)i, &latest.echo[i], &fallUs[i]);
+    }
     
-    // Stop TPM2 before configuring
-    TPM2->SC = 0;
-    TPM2->CNT = 0;
+    // Crosstalk: same wavefront at both sensors, only one of them jumped to it
+    if (front->status == ULTRASONIC_OK && rear->status == ULTRASONIC_OK &&
+        Ultrasonic_AbsDiff(fallUs[ULTRASONIC_FRONT], fallUs[ULTRASONIC_REAR]) < CROSSTALK_WINDOW_US) {
+        bool frontJumped = Ultrasonic_Jumped(ULTRASONIC_FRONT, front);
+        bool rearJumped = Ultrasonic_Jumped(ULTRASONIC_REAR, rear);
+        
+        if (frontJumped != rearJumped) {
+            UltrasonicEcho_t *ghost = frontJumped ? front : rear;
+            
+            ghost->pulseUs = 0;
+            ghost->distanceCm = ULTRASONIC_TIMEOUT_CM;
+            ghost->status = ULTRASONIC_CROSSTALK;
+        }
+    }
+    
+    for (uint32_t i = 0; i < ULTRASONIC_SENSOR_COUNT; i++) {
+        if (latest.echo[i].status != ULTRASONIC_CROSSTALK) {
+            sensors[i].lastPulseUs = latest.echo[i].pulseUs;  // 0 after a miss: no reference
+        }
+    }
     
-    // Set prescaler to divide by 32 (PS=5)
-    TPM2->SC = TPM_SC_PS(TPM2_PRESCALER);
-    TPM2->MOD = 0xFFFF;
+    latest.timeUs = triggerUs;
+    latest.sequence++;
+    pingBusy = false;
     
-    // Start TPM2 with internal clock
-    TPM2->SC |= TPM_SC_CMOD(1);
+    Ultrasonic_PublishSnapshot();
+}
+
+/**
+ * @brief One sensor's DMA is done: both of its edges are captured
+ * @note Caller must have interrupts masked (or be the DMA ISR)
+ */
+static void Ultrasonic_EchoDone(UltrasonicSensor_t sensor)
+{
+    DMA_ClearChannelStatusFlags(DMA0, sensorHw[sensor].dmaChannel, kDMA_TransactionsDoneFlag);
+    if (!pingBusy) {
+        return;
+    }
     
-    UART_SendString("  TPM2 timer configured (1.5MHz)\r\n");
+    sensors[sensor].done = true;
+    for (uint32_t i = 0; i < ULTRASONIC_SENSOR_COUNT; i++) {
+        if (!sensors[i].done) {
+            return;
+        }
+    }
+    Ultrasonic_Finish();
+}
+
+/**
+ * @brief Pick up finished or timed-out echoes without the ISRs
+ * @note Caller must have interrupts masked
+ */
+static void Ultrasonic_Poll(void)
+{
+    for (uint32_t i = 0; i < ULTRASONIC_SENSOR_COUNT && pingBusy; i++) {
+        if (!sensors[i].done &&
+            (DMA_GetChannelStatusFlags(DMA0, sensorHw[i].dmaChannel) & kDMA_TransactionsDoneFlag)) {
+            Ultrasonic_EchoDone((UltrasonicSensor_t)i);
+        }
+    }
+    if (pingBusy && Timebase_ElapsedUs(triggerUs) > ULTRASONIC_PING_TIMEOUT_US) {
+        Ultrasonic_Finish();
+    }
+}
+
+/**
+ * @brief Route one ECHO pin to its capture channel and DMA channel
+ */
+static void Ultrasonic_InitCapture(UltrasonicSensor_t sensor)
+{
+    const UltrasonicHw_t *hw = &sensorHw[sensor];
+    dma_transfer_config_t config;
+    
+    // Input capture on both edges; DMA request instead of the interrupt
+    hw->tpm->CONTROLS[hw->tpmChannel].CnSC = 0;
+    hw->tpm->CONTROLS[hw->tpmChannel].CnSC = TPM_CnSC_ELSA_MASK | TPM_CnSC_ELSB_MASK |
+                                             TPM_CnSC_CHIE_MASK | TPM_CnSC_DMA_MASK;
+    
+    // Every edge: PIT1 CVAL -> edges[n]
+    DMA_ResetChannel(DMA0, hw->dmaChannel);
+    DMA_PrepareTransfer(&config, (void *)&PIT->CHANNEL[1].CVAL, sizeof(uint32_t),
+                        (void *)sensors[sensor].edges, sizeof(uint32_t),
+                        sizeof(sensors[sensor].edges), kDMA_PeripheralToMemory);
+    DMA_SetTransferConfig(DMA0, hw->dmaChannel, &config);
+    DMA_EnableInterrupts(DMA0, hw->dmaChannel);
 }
 
 void Ultrasonic_Init(void)
@@ -149,14 +355,6 @@ void Ultrasonic_Init(void)
         .outputLogic = 0U
     };
     
-    gpio_pin_config_t echoConfig = {
-        .pinDirection = kGPIO_DigitalInput,
-        .outputLogic = 0U
-    };
-    
-    // Initialize TPM2 timer first
-    Ultrasonic_InitTimer();
-    
     // Enable Port clocks
     CLOCK_EnableClock(kCLOCK_PortA);  // For PTA12 (rear ECHO)
     CLOCK_EnableClock(kCLOCK_PortC);  // For PTC8 (TRIG) and PTC9 (front ECHO)
@@ -165,95 +363,221 @@ void Ultrasonic_Init(void)
     PORT_SetPinMux(ULTRASONIC_TRIG_PORT, ULTRASONIC_TRIG_PIN, kPORT_MuxAsGpio);
     GPIO_PinInit(ULTRASONIC_TRIG_GPIO, ULTRASONIC_TRIG_PIN, &trigConfig);
     
-    // Configure FRONT ECHO pin (PTC9) as input
-    PORT_SetPinMux(ULTRASONIC_ECHO_FRONT_PORT, ULTRASONIC_ECHO_FRONT_PIN, kPORT_MuxAsGpio);
-    GPIO_PinInit(ULTRASONIC_ECHO_FRONT_GPIO, ULTRASONIC_ECHO_FRONT_PIN, &echoConfig);
+    // ECHO pins to the capture channels (inputs by default, PDIR still reads them)
+    PORT_SetPinMux(ULTRASONIC_ECHO_FRONT_PORT, ULTRASONIC_ECHO_FRONT_PIN, kPORT_MuxAlt3);  // TPM0_CH5
+    PORT_SetPinMux(ULTRASONIC_ECHO_REAR_PORT, ULTRASONIC_ECHO_REAR_PIN, kPORT_MuxAlt3);    // TPM1_CH0
+    
+    // Capture needs the counters running. TPM0 is the motor PWM (Motor_Init
+    // starts it); start it free-running if this runs without the motors
+    SIM->SCGC6 |= SIM_SCGC6_TPM0_MASK | SIM_SCGC6_TPM1_MASK;
+    SIM->SOPT2 = (SIM->SOPT2 & ~SIM_SOPT2_TPMSRC_MASK) | SIM_SOPT2_TPMSRC(1);
+    if ((TPM0->SC & TPM_SC_CMOD_MASK) == 0) {
+        TPM0->MOD = 0xFFFFU;
+        TPM0->SC = TPM_SC_CMOD(1);
+    }
+    // TPM1: rear capture, and its overflow paces the background ranging
+    TPM1->SC = 0;
+    TPM1->MOD = (CLOCK_GetFreq(kCLOCK_PllFllSelClk) >> RANGING_TPM_PS) / 1000U * ULTRASONIC_RANGING_PERIOD_MS - 1U;
+    TPM1->SC = TPM_SC_PS(RANGING_TPM_PS) | TPM_SC_CMOD(1);
+    
+    DMAMUX_Init(DMAMUX0);
+    DMAMUX_SetSource(DMAMUX0, ULTRASONIC_FRONT_DMA_CHANNEL, kDmaRequestMux0TPM0Channel5);
+    DMAMUX_EnableChannel(DMAMUX0, ULTRASONIC_FRONT_DMA_CHANNEL);
+    DMAMUX_SetSource(DMAMUX0, ULTRASONIC_REAR_DMA_CHANNEL, kDmaRequestMux0TPM1Channel0);
+    DMAMUX_EnableChannel(DMAMUX0, ULTRASONIC_REAR_DMA_CHANNEL);
+    DMA_Init(DMA0);
+    
+    pingBusy = false;
+    readSequence = 0;
+    snapshot.frontCm = ULTRASONIC_TIMEOUT_CM;
+    snapshot.rearCm = ULTRASONIC_TIMEOUT_CM;
+    snapshot.timeUs = 0;
+    snapshot.sequence = 0;
+    snapshot.valid = 0;
+    snapshot.frontConfidence = 0;
+    snapshot.rearConfidence = 0;
+    latest.timeUs = 0;
+    latest.sequence = 0;
+    for (uint32_t i = 0; i < ULTRASONIC_SENSOR_COUNT; i++) {
+        sensors[i].done = false;
+        sensors[i].lastPulseUs = 0;
+        RangeFilter_Reset(&filters[i]);
+        latest.echo[i].distanceCm = ULTRASONIC_TIMEOUT_CM;
+        latest.echo[i].pulseUs = 0;
+        latest.echo[i].status = ULTRASONIC_NO_ECHO;
+        Ultrasonic_InitCapture((UltrasonicSensor_t)i);
+    }
     
-    // Configure REAR ECHO pin (PTA12) as input
-    PORT_SetPinMux(ULTRASONIC_ECHO_REAR_PORT, ULTRASONIC_ECHO_REAR_PIN, kPORT_MuxAsGpio);
-    GPIO_PinInit(ULTRASONIC_ECHO_REAR_GPIO, ULTRASONIC_ECHO_REAR_PIN, &echoConfig);
+    NVIC_SetPriority(DMA2_IRQn, 2);
+    NVIC_SetPriority(DMA3_IRQn, 2);
+    NVIC_EnableIRQ(DMA2_IRQn);
+    NVIC_EnableIRQ(DMA3_IRQn);
+    NVIC_SetPriority(TPM1_IRQn, 2);
+    NVIC_EnableIRQ(TPM1_IRQn);
     
     // Ensure TRIG starts LOW
     Ultrasonic_SetTrig(0);
     
     // Wait for sensors to stabilize (50ms)
-    Ultrasonic_DelayUs(50000);
+    Timebase_DelayMs(50);
 
     UART_SendString("  ULTRASONIC (DUAL) init finish\r\n");
-    UART_SendString("    FRONT: TRIG=PTC8, ECHO=PTC9\r\n");
-    UART_SendString("    REAR:  TRIG=PTC8, ECHO=PTA12\r\n");
+    UART_SendString("    FRONT: TRIG=PTC8, ECHO=PTC9 (TPM0_CH5)\r\n");
+    UART_SendString("    REAR:  TRIG=PTC8, ECHO=PTA12 (TPM1_CH0)\r\n");
 }
 
-uint32_t Ultrasonic_GetPulseUs(UltrasonicSensor_t sensor)
+bool Ultrasonic_StartMeasurement(void)
 {
-    uint16_t startTicks, endTicks, waitStart;
-    uint16_t pulseTicks;
-    
-    // Check initial ECHO state
-    if (Ultrasonic_ReadEcho(sensor) == 1) {
-        // Wait for ECHO to go LOW with timeout
-        waitStart = Ultrasonic_GetTicks();
-        while (Ultrasonic_ReadEcho(sensor) == 1) {
-            if (Ultrasonic_ElapsedTicks(waitStart, Ultrasonic_GetTicks()) > SHORT_TIMEOUT_TICKS) {
-                return 0;
-            }
-        }
+    uint32_t primask = DisableGlobalIRQ();
+    
+    Ultrasonic_Poll();
+    
+    // Still measuring, or an ECHO still high from the last one (capture
+    // would take its falling edge as ours)
+    if (pingBusy || Ultrasonic_ReadEcho(ULTRASONIC_FRONT) || Ultrasonic_ReadEcho(ULTRASONIC_REAR)) {
+        EnableGlobalIRQ(primask);
+        return false;
     }
     
-    // Ensure TRIG is LOW before starting
-    Ultrasonic_SetTrig(0);
-    Ultrasonic_DelayUs(2);
+    // Re-arm: drop any stale edge, two fresh timestamps per sensor
+    for (uint32_t i = 0; i < ULTRASONIC_SENSOR_COUNT; i++) {
+        const UltrasonicHw_t *hw = &sensorHw[i];
+        UltrasonicChannel_t *ch = &sensors[i];
+        
+        DMA_DisableChannelRequest(DMA0, hw->dmaChannel);
+        DMA_ClearChannelStatusFlags(DMA0, hw->dmaChannel, kDMA_TransactionsDoneFlag);
+        DMA_SetDestinationAddress(DMA0, hw->dmaChannel, (uint32_t)ch->edges);
+        DMA_SetTransferSize(DMA0, hw->dmaChannel, sizeof(ch->edges));
+        hw->tpm->CONTROLS[hw->tpmChannel].CnSC |= TPM_CnSC_CHF_MASK;  // Write 1 to clear
+        DMA_EnableChannelRequest(DMA0, hw->dmaChannel);
+        ch->done = false;
+    }
+    
+    triggerUs = Timebase_GetUs();
+    pingBusy = true;
+    EnableGlobalIRQ(primask);
     
-    // Send 10µs trigger pulse
+    // Send 10µs trigger pulse to both sensors (the echoes start ~0.5ms later)
     Ultrasonic_SetTrig(1);
-    Ultrasonic_DelayUs(10);
+    Timebase_DelayUs(10);
     Ultrasonic_SetTrig(0);
     
-    // Wait for ECHO to go HIGH (with timeout)
-    waitStart = Ultrasonic_GetTicks();
-    while (Ultrasonic_ReadEcho(sensor) == 0) {
-        if (Ultrasonic_ElapsedTicks(waitStart, Ultrasonic_GetTicks()) > SHORT_TIMEOUT_TICKS) {
-            return 0;
-        }
-    }
-    
-    // Capture start time
-    startTicks = Ultrasonic_GetTicks();
+    return true;
+}
+
+/**
+ * @brief Copy the latest reading without marking it as read
+ */
+static void Ultrasonic_Peek(UltrasonicReading_t *out)
+{
+    uint32_t primask = DisableGlobalIRQ();
     
-    // Wait for ECHO to go LOW
-    while (Ultrasonic_ReadEcho(sensor) == 1) {
-        if (Ultrasonic_ElapsedTicks(startTicks, Ultrasonic_GetTicks()) > TIMEOUT_TICKS) {
-            return 0;
-        }
-    }
+    Ultrasonic_Poll();
+    *out = latest;
+    EnableGlobalIRQ(primask);
+}
+
+bool Ultrasonic_GetLatest(UltrasonicReading_t *out)
+{
+    uint32_t primask = DisableGlobalIRQ();
     
-    // Capture end time
-    endTicks = Ultrasonic_GetTicks();
+    Ultrasonic_Poll();
+    *out = latest;
+    bool fresh = (latest.sequence != readSequence);
+    readSequence = latest.sequence;
     
-    // Calculate pulse width
-    pulseTicks = Ultrasonic_ElapsedTicks(startTicks, endTicks);
+    EnableGlobalIRQ(primask);
+    return fresh;
+}
+
+bool Ultrasonic_Busy(void)
+{
+    return pingBusy;
+}
+
+void Ultrasonic_StartRanging(void)
+{
+    TPM1->SC |= TPM_SC_TOF_MASK | TPM_SC_TOIE_MASK;  // Clear stale overflow, enable
+}
+
+void Ultrasonic_StopRanging(void)
+{
+    TPM1->SC &= ~TPM_SC_TOIE_MASK;  // Counter keeps running for the capture
+}
+
+void Ultrasonic_GetSnapshot(DistanceSnapshot_t *out)
+{
+    uint32_t seq;
     
-    return Ultrasonic_TicksToUs(pulseTicks);
+    do {
+        seq = snapshotSeq;
+        __DMB();
+        *out = snapshot;
+        __DMB();
+    } while ((seq & 1U) || seq != snapshotSeq);
 }
 
-uint32_t Ultrasonic_GetDistanceCm_Sensor(UltrasonicSensor_t sensor)
+/**
+ * @brief TPM1 overflow: next background ping
+ * @note Skipped if the previous one is still running or an ECHO is high
+ */
+void TPM1_IRQHandler(void)
+{
+    TPM1->SC |= TPM_SC_TOF_MASK;  // Write 1 to clear
+    Ultrasonic_StartMeasurement();
+}
+
+/**
+ * @brief DMA channel 2 done: FRONT echo captured
+ */
+void DMA2_IRQHandler(void)
+{
+    Ultrasonic_EchoDone(ULTRASONIC_FRONT);
+}
+
+/**
+ * @brief DMA channel 3 done: REAR echo captured
+ */
+void DMA3_IRQHandler(void)
+{
+    Ultrasonic_EchoDone(ULTRASONIC_REAR);
+}
+
+void Ultrasonic_Measure(UltrasonicReading_t *out)
 {
-    uint32_t pulseUs = Ultrasonic_GetPulseUs(sensor);
+    uint32_t waitStart = Timebase_GetUs();
     
-    if (pulseUs == 0) {
-        return ULTRASONIC_TIMEOUT_CM;
+    // Wait out a measurement in flight / ECHO still high from the last one
+    while (!Ultrasonic_StartMeasurement()) {
+        if (Timebase_ElapsedUs(waitStart) > ULTRASONIC_PING_TIMEOUT_US + SHORT_TIMEOUT_US) {
+            Ultrasonic_Peek(out);
+            return;
+        }
     }
     
-    uint32_t distanceCm = pulseUs / 58;
+    // Peek polls the DMA, so this also works with interrupts masked. It
+    // leaves the reading unread for Ultrasonic_GetLatest() callers
+    Ultrasonic_Peek(out);
+    uint32_t sequence = out->sequence;
+    do {
+        Ultrasonic_Peek(out);
+    } while (out->sequence == sequence);
+}
+
+uint32_t Ultrasonic_GetPulseUs(UltrasonicSensor_t sensor)
+{
+    UltrasonicReading_t reading;
     
-    if (distanceCm < ULTRASONIC_MIN_DISTANCE_CM) {
-        return ULTRASONIC_MIN_DISTANCE_CM;
-    }
-    if (distanceCm > ULTRASONIC_MAX_DISTANCE_CM) {
-        return ULTRASONIC_TIMEOUT_CM;
-    }
+    Ultrasonic_Measure(&reading);
+    return reading.echo[sensor].pulseUs;
+}
+
+uint32_t Ultrasonic_GetDistanceCm_Sensor(UltrasonicSensor_t sensor)
+{
+    UltrasonicReading_t reading;
     
-    return distanceCm;
+    Ultrasonic_Measure(&reading);
+    return reading.echo[sensor].distanceCm;
 }
 
 // Backward compatible - reads FRONT sensor
@@ -10,14 +10,28 @@
  * Connections:
  *   FRONT Sensor:
  *   - TRIG: PTC8 (shared) - GPIO Output
- *   - ECHO: PTC9 - GPIO Input (needs voltage divider 5V->3.3V)
+ *   - ECHO: PTC9 - TPM0_CH5 input capture (needs voltage divider 5V->3.3V)
  * 
  *   REAR Sensor:
  *   - TRIG: PTC8 (shared) - GPIO Output  
- *   - ECHO: PTA12 - GPIO Input (needs voltage divider 5V->3.3V)
+ *   - ECHO: PTA12 - TPM1_CH0 input capture (needs voltage divider 5V->3.3V)
  *   
  *   - VCC:  5V (external)
  *   - GND:  Common ground with FRDM
+ * 
+ * TRIG is shared, so every measurement pings both sensors at once and
+ * times both echoes: one reading holds FRONT and REAR from the same
+ * trigger. It runs in the background: Ultrasonic_StartMeasurement() sends
+ * the trigger and returns, the echo edges are timestamped by hardware and
+ * Ultrasonic_GetLatest() picks up the result later. The blocking calls
+ * below wait for it (up to ~40ms) - tests only.
+ * 
+ * Ultrasonic_StartRanging() pings every ULTRASONIC_RANGING_PERIOD_MS from
+ * the TPM1 overflow interrupt and publishes each pair to a seqlock
+ * snapshot after a median / outlier filter (range_filter.h). The raw
+ * readings stay available from Ultrasonic_GetLatest().
+ * Ultrasonic_GetSnapshot() is a plain copy, never blocks and
+ * never sees half of one reading and half of the next.
  */
 
 // Sensor selection
@@ -26,18 +40,93 @@ typedef enum {
     ULTRASONIC_REAR  = 1
 } UltrasonicSensor_t;
 
+#define ULTRASONIC_SENSOR_COUNT     2U
+
 // Measurement range
 #define ULTRASONIC_MIN_DISTANCE_CM  2U      // Minimum reliable distance
 #define ULTRASONIC_MAX_DISTANCE_CM  400U    // Maximum reliable distance
 #define ULTRASONIC_TIMEOUT_CM       500U    // Return this on timeout/error
 
+typedef enum {
+    ULTRASONIC_OK = 0,
+    ULTRASONIC_NO_ECHO,         // Timed out or out of range
+    ULTRASONIC_CROSSTALK        // Rejected: echo of the other sensor's ping
+} UltrasonicStatus_t;
+
+// One sensor's echo
+typedef struct {
+    uint32_t distanceCm;        // 2-400, ULTRASONIC_TIMEOUT_CM unless ULTRASONIC_OK
+    uint32_t pulseUs;           // Echo pulse width, 0 unless ULTRASONIC_OK
+    UltrasonicStatus_t status;
+} UltrasonicEcho_t;
+
+// One finished measurement: both sensors, same trigger
+typedef struct {
+    UltrasonicEcho_t echo[ULTRASONIC_SENSOR_COUNT];  // Indexed by UltrasonicSensor_t
+    uint32_t timeUs;            // Trigger time (Timebase_GetUs)
+    uint32_t sequence;          // Counts finished measurements (0 = none yet)
+} UltrasonicReading_t;
+
+// Background ranging period (TPM1 overflow); an echo takes up to ~38ms
+#define ULTRASONIC_RANGING_PERIOD_MS    50U
+
+// DistanceSnapshot_t.valid bits
+#define ULTRASONIC_VALID(sensor)    (1U << (sensor))
+
+// Latest background reading, filtered (range_filter.h), published under a seqlock
+typedef struct {
+    uint32_t frontCm;           // Filtered estimate, ULTRASONIC_TIMEOUT_CM unless valid
+    uint32_t rearCm;
+    uint32_t timeUs;            // Trigger time (Timebase_GetUs)
+    uint32_t sequence;          // Reading number (0 = none yet)
+    uint8_t valid;              // ULTRASONIC_VALID(sensor): the filter has an estimate
+    uint8_t frontConfidence;    // 0-100
+    uint8_t rearConfidence;
+} DistanceSnapshot_t;
+
 /**
- * @brief Initialize both ultrasonic sensor GPIO pins
+ * @brief Initialize both ultrasonic sensors (pins, capture channels, DMA)
  */
 void Ultrasonic_Init(void);
 
 /**
- * @brief Get distance measurement from specific sensor
+ * @brief Trigger both sensors and return at once (~12us)
+ * @return false if the previous measurement is still running
+ */
+bool Ultrasonic_StartMeasurement(void);
+
+/**
+ * @brief Latest finished measurement
+ * @param out Filled with the latest reading (sequence 0 if there is none yet)
+ * @return true if it is new since the previous call
+ */
+bool Ultrasonic_GetLatest(UltrasonicReading_t *out);
+
+/**
+ * @brief Trigger both sensors and wait for the result (blocking)
+ */
+void Ultrasonic_Measure(UltrasonicReading_t *out);
+
+/**
+ * @brief Start / stop pinging both sensors every ULTRASONIC_RANGING_PERIOD_MS
+ */
+void Ultrasonic_StartRanging(void);
+void Ultrasonic_StopRanging(void);
+
+/**
+ * @brief Copy of the latest published reading (lock-free, O(1))
+ * @note Not from an interrupt that can preempt the DMA2/DMA3/TPM1 ISRs
+ *       (priority 2): it would spin on a snapshot that is half written
+ */
+void Ultrasonic_GetSnapshot(DistanceSnapshot_t *out);
+
+/**
+ * @brief true while a measurement is in flight (capture stops in VLPS)
+ */
+bool Ultrasonic_Busy(void);
+
+/**
+ * @brief Get distance measurement from specific sensor (blocking)
  * @param sensor Which sensor to read (ULTRASONIC_FRONT or ULTRASONIC_REAR)
  * @return Distance in cm (2-400), or ULTRASONIC_TIMEOUT_CM on error
  */
@@ -70,7 +159,7 @@ bool Ultrasonic_ObstacleDetected(uint32_t thresholdCm);
 bool Ultrasonic_RearObstacleDetected(uint32_t thresholdCm);
 
 /**
- * @brief Get raw echo pulse duration in microseconds from specific sensor
+ * @brief Get raw echo pulse duration in microseconds from specific sensor (blocking)
  * @param sensor Which sensor to read
  * @return Pulse duration in µs, or 0 on timeout
  */
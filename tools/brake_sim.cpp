@@ -0,0 +1,135 @@
+/**
+ * Host-side stopping distance simulator for the Motor_Stop* policies
+ *
+ * Drives a simple model of the car (two DC gear motors behind an L293D,
+ * enable-pin PWM) up to each speed setting with the firmware's own motion
+ * profile, then stops it four ways and prints the distance rolled:
+ *   coast        Motor_StopWith(MOTOR_STOP_COAST)
+ *   ramp         Motor_Stop(): profile ramps the duty down, then coasts
+ *   brake        Motor_StopWith(MOTOR_STOP_BRAKE)
+ *   brake+coast  Motor_StopWith(MOTOR_STOP_BRAKE_COAST), 300ms brake
+ *
+ * Model: driving force only while EN is high (the bridge floats in the
+ * PWM off time), shorted-motor braking force proportional to speed,
+ * constant plus viscous friction. The constants below are typical for a
+ * TT gear motor chassis on 4xAA; measure yours and edit them - the
+ * ranking of the policies does not depend on the exact values.
+ *
+ * Build:  g++ -std=c++17 -O2 -o brake_sim tools/brake_sim.cpp
+ * Usage:  brake_sim [-t brake_ms]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Same profile code as the firmware (plain C, no hardware access)
+#include "../source/motion.c"
+
+namespace {
+
+constexpr double kDt = 1.0 / MOTION_TICK_HZ;  // One profile tick
+constexpr double kSupplyV = 4.5;    // Battery minus L293D drop
+constexpr double kKe = 5.5;         // Back-EMF per wheel speed, V/(m/s)
+constexpr double kMotorR = 5.0;     // Winding resistance, ohm
+constexpr double kBrakeR = 1.5;     // L293D path while both outputs are high, ohm
+constexpr double kGearEff = 0.5;    // Gearbox efficiency
+constexpr double kMassKg = 0.6;
+constexpr double kFrictionN = 0.6;  // Rolling + gearbox drag
+constexpr double kViscousN = 0.5;   // Per m/s
+constexpr int kMotors = 2;
+
+enum class Stop { Coast, Ramp, Brake, BrakeCoast };
+
+// Net force on the car at speed v (m/s, >= 0)
+double Force(double v, double duty, bool brake)
+{
+    double motor = 0;
+    if (brake) {
+        motor = -kGearEff * kKe * (kKe * v) / (kMotorR + kBrakeR);
+    } else if (duty > 0) {
+        double current = (kSupplyV - kKe * v) / kMotorR;
+        motor = (current > 0) ? duty * kGearEff * kKe * current : 0;
+    }
+    if (v <= 0 && kMotors * motor <= kFrictionN) {
+        return 0;  // Static friction holds a car that is not moving
+    }
+    return kMotors * motor - kFrictionN - kViscousN * v;
+}
+
+struct Car {
+    MotionAxis_t axis;
+    double v = 0;
+
+    void Step(bool brake)
+    {
+        double duty = brake ? 0 : Motion_DutyQ8(&axis) / 25600.0;
+        double f = Force(v, duty, brake);
+        v += f / kMassKg * kDt;
+        if (v < 0) {
+            v = 0;
+        }
+    }
+};
+
+// Cruise at percent, then stop; returns distance in cm (speed in cm/s)
+double StoppingDistance(int percent, Stop stop, int brakeMs, double &cruise)
+{
+    Car car;
+    Motion_Reset(&car.axis);
+    Motion_SetTarget(&car.axis, static_cast<int16_t>(percent));
+    for (int t = 0; t < 3 * static_cast<int>(MOTION_TICK_HZ); t++) {
+        Motion_Step(&car.axis);
+        car.Step(false);
+    }
+    cruise = car.v * 100;
+
+    double distance = 0;
+    Motion_SetTarget(&car.axis, 0);
+    for (int t = 0; car.v > 0 && t < 10 * static_cast<int>(MOTION_TICK_HZ); t++) {
+        bool brake = (stop == Stop::Brake) || (stop == Stop::BrakeCoast && t < brakeMs);
+        if (stop == Stop::Ramp) {
+            Motion_Step(&car.axis);
+        } else {
+            Motion_Reset(&car.axis);
+        }
+        car.Step(brake);
+        distance += car.v * kDt;
+    }
+    return distance * 100;
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    int brakeMs = 300;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            brakeMs = std::atoi(argv[++i]);
+        } else {
+            std::fprintf(stderr, "usage: brake_sim [-t brake_ms]\n");
+            return 1;
+        }
+    }
+
+    std::printf("%-6s %8s %9s %9s %9s %12s %8s\n", "speed", "cm/s", "coast cm", "ramp cm", "brake cm",
+                "brk+cst cm", "saved");
+    for (int percent = 10; percent <= 100; percent += 10) {
+        double cruise;
+        double coast = StoppingDistance(percent, Stop::Coast, brakeMs, cruise);
+        double ramp = StoppingDistance(percent, Stop::Ramp, brakeMs, cruise);
+        double brake = StoppingDistance(percent, Stop::Brake, brakeMs, cruise);
+        double brakeCoast = StoppingDistance(percent, Stop::BrakeCoast, brakeMs, cruise);
+
+        if (cruise <= 0) {
+            std::printf("%5d%% %8s   (below the motor deadband)\n", percent, "0");
+            continue;
+        }
+        std::printf("%5d%% %8.1f %9.1f %9.1f %9.1f %12.1f %7.0f%%\n", percent, cruise, coast, ramp, brake,
+                    brakeCoast, 100.0 * (coast - brakeCoast) / coast);
+    }
+    std::printf("\nsaved: brake+coast (obstacle stop) vs coast\n");
+    return 0;
+}
@@ -0,0 +1,202 @@
+/**
+ * Host-side benchmark of the decimal formatting (see source/fmt.h)
+ *
+ * Times Fmt_U32() against the "% 10, / 10" loop UART_SendNumber() used
+ * before, over the same value set (uniform 32-bit values plus the small
+ * numbers the firmware mostly prints: distances, percentages, counters),
+ * and checks that both give the same text. Then checks Fmt_Div100()
+ * against n / 100 for every 32-bit input.
+ *
+ * The Cortex-M0+ has no divide instruction: the old loop's % 10 and / 10
+ * are one __aeabi_uidivmod call per digit, a shift-and-subtract routine.
+ * The host would use its divider (or turn / 10 into a multiply), so the
+ * old loop runs here with the same kind of shift-and-subtract divide
+ * (SoftDivMod). Per call the tool also counts the operations that cost
+ * on the target: software divides (old) and 32x32->64 multiplies (the
+ * Fmt_Div100 path for n >= 43699, an __aeabi_lmul call). Cycles are the
+ * host's TSC (x86), ns elsewhere - compare the columns with each other,
+ * not with the target.
+ *
+ * Build:  g++ -std=c++17 -O2 -o fmt_bench tools/fmt_bench.cpp
+ * Usage:  fmt_bench [-n calls] [-q]     (-q: skip the exhaustive Div100 check)
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#else
+#define HAVE_TSC 0
+#endif
+
+// Same formatting code as the firmware (plain C, no hardware access)
+#include "../source/fmt.c"
+
+namespace {
+
+volatile uint32_t gSink;
+
+// Unsigned divide without a divide instruction (what __aeabi_uidivmod
+// does on the M0+): align the divisor under the dividend, then one
+// compare/subtract per quotient bit
+uint32_t SoftDivMod(uint32_t n, uint32_t d, uint32_t *rem)
+{
+    uint32_t q = 0, bit = 1;
+
+    while (d <= n && !(d & 0x80000000U)) {
+        d <<= 1;
+        bit <<= 1;
+    }
+    while (bit) {
+        if (n >= d) {
+            n -= d;
+            q |= bit;
+        }
+        d >>= 1;
+        bit >>= 1;
+    }
+    *rem = n;
+    return q;
+}
+
+// UART_SendNumber() digit loop before fmt.c
+uint8_t OldU32(char *buf, uint32_t num)
+{
+    char tmp[12];
+    uint8_t i = 0;
+
+    if (num == 0) {
+        buf[0] = '0';
+        return 1;
+    }
+    while (num > 0) {
+        uint32_t digit;
+        num = SoftDivMod(num, 10, &digit);  // num % 10, num / 10
+        tmp[i++] = static_cast<char>('0' + digit);
+    }
+    for (uint8_t k = 0; k < i; k++) {
+        buf[k] = tmp[i - 1 - k];
+    }
+    return i;
+}
+
+uint64_t Now()
+{
+#if HAVE_TSC
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+template <typename F>
+double PerCall(F format, const std::vector<uint32_t> &values)
+{
+    char buf[FMT_U32_MAX_LEN];
+    uint32_t sum = 0;
+
+    uint64_t start = Now();
+    for (uint32_t v : values) {
+        sum += format(buf, v) + static_cast<uint8_t>(buf[0]);
+    }
+    uint64_t end = Now();
+
+    gSink = sum;
+    return static_cast<double>(end - start) / values.size();
+}
+
+// Target-cost operations per call: software divides for the old loop,
+// wide multiplies for Fmt_U32 (one Fmt_Div100 per two digits)
+void CountOps(const std::vector<uint32_t> &values, double *divides, double *wideMuls)
+{
+    uint64_t d = 0, m = 0;
+
+    for (uint32_t v : values) {
+        uint32_t n = v;
+        do {
+            d++;
+            n /= 10U;
+        } while (n);
+        for (n = v; n >= 100U; n = Fmt_Div100(n)) {
+            m += (n >= 43699U);
+        }
+    }
+    *divides = static_cast<double>(d) / values.size();
+    *wideMuls = static_cast<double>(m) / values.size();
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    size_t calls = 2000000;
+    bool exhaustive = true;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            calls = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "-q") == 0) {
+            exhaustive = false;
+        } else {
+            std::fprintf(stderr, "usage: fmt_bench [-n calls] [-q]\n");
+            return 1;
+        }
+    }
+
+    std::mt19937 rng(12345);
+    std::vector<uint32_t> full(calls), small(calls);
+    for (size_t i = 0; i < calls; i++) {
+        full[i] = rng();
+        small[i] = rng() % 10000U;
+    }
+
+    // Same text from both
+    for (const auto *set : {&full, &small}) {
+        for (uint32_t v : *set) {
+            char a[FMT_U32_MAX_LEN], b[12];
+            uint8_t la = Fmt_U32(a, v), lb = OldU32(b, v);
+            if (la != lb || std::memcmp(a, b, la) != 0) {
+                std::printf("MISMATCH at %u\n", v);
+                return 1;
+            }
+        }
+    }
+
+    const char *unit = HAVE_TSC ? "cycles" : "ns";
+    std::printf("%-16s %12s %12s %8s %10s %10s\n", "values", "% 10 loop", "Fmt_U32", "speedup", "divides",
+                "wide muls");
+    const struct {
+        const char *name;
+        const std::vector<uint32_t> *values;
+    } sets[] = {{"uniform 32-bit", &full}, {"0-9999", &small}};
+    for (const auto &s : sets) {
+        PerCall(OldU32, *s.values);  // Warm up
+        double old = PerCall(OldU32, *s.values);
+        double now = PerCall(Fmt_U32, *s.values);
+        double divides, wideMuls;
+        CountOps(*s.values, &divides, &wideMuls);
+        std::printf("%-16s %9.1f %-2s %9.1f %-2s %7.1fx %10.2f %10.2f\n", s.name, old, HAVE_TSC ? "cy" : "ns",
+                    now, HAVE_TSC ? "cy" : "ns", old / now, divides, wideMuls);
+    }
+    std::printf("(%s per call, %zu calls per set; divides / wide muls: per call, on the target)\n", unit,
+                calls);
+
+    if (exhaustive) {
+        uint32_t n = 0;
+        do {
+            if (Fmt_Div100(n) != n / 100U) {
+                std::printf("Fmt_Div100(%u) = %u, expected %u\n", n, Fmt_Div100(n), n / 100U);
+                return 1;
+            }
+        } while (++n != 0);
+        std::printf("Fmt_Div100 exact for all 2^32 inputs\n");
+    }
+    return 0;
+}
@@ -0,0 +1,295 @@
+/**
+ * Host-side check of the FSM transition matrix (see source/car_fsm.c)
+ *
+ * Builds the firmware's car_fsm.c against recording stubs (Motor_*,
+ * Msg_Send, SwTimer_*) and runs every state x event pair through
+ * FSM_ProcessEvent(). Each outcome - next state, motor calls, messages,
+ * turn timer calls - is compared with a transcription of the per-state
+ * switch handlers the matrix replaced, plus the changes made on purpose
+ * since then (listed in Reference()).
+ *
+ * C, not C++ like the other tools: car_fsm.c initializes its tables with
+ * array designators, which g++ does not accept.
+ *
+ * Build:  gcc -std=gnu99 -Itools/stubs -o fsm_check tools/fsm_check.c
+ * Usage:  fsm_check [-v]
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Time only feeds the profiler here: no PIT on the host
+#define TIMEBASE_H
+static inline uint32_t Timebase_GetUs(void) { return 0; }
+static inline uint32_t Timebase_ElapsedUs(uint32_t startUs) { return 0U - startUs; }
+
+// Same FSM code as the firmware
+#include "../source/car_fsm.c"
+
+#define TEST_SPEED  70U     // Any speed that is not the default
+
+typedef struct {
+    CarState_t state;
+    char motor[64];     // Motor calls, in order
+    char msgs[64];      // Message ids, in order
+    char timer[64];     // Turn timer calls, in order
+} Outcome_t;
+
+static Outcome_t *rec;
+
+static void Append(char *log, size_t size, const char *fmt, ...)
+{
+    size_t len = strlen(log);
+    va_list args;
+
+    if (len > 0 && len + 1 < size) {
+        log[len++] = ' ';
+        log[len] = '\0';
+    }
+    va_start(args, fmt);
+    vsnprintf(log + len, size - len, fmt, args);
+    va_end(args);
+}
+
+// --------------------------------------------
+// Stubs for everything car_fsm.c calls
+// --------------------------------------------
+
+void Motor_Forward(uint8_t speed)   { Append(rec->motor, sizeof(rec->motor), "Forward(%u)", speed); }
+void Motor_Backward(uint8_t speed)  { Append(rec->motor, sizeof(rec->motor), "Backward(%u)", speed); }
+void Motor_TurnLeft(uint8_t speed)  { Append(rec->motor, sizeof(rec->motor), "TurnLeft(%u)", speed); }
+void Motor_TurnRight(uint8_t speed) { Append(rec->motor, sizeof(rec->motor), "TurnRight(%u)", speed); }
+void Motor_Stop(void)               { Append(rec->motor, sizeof(rec->motor), "Stop"); }
+
+void Motor_StopWith(MotorStopPolicy_t policy)
+{
+    Append(rec->motor, sizeof(rec->motor), "StopWith(%u)", (unsigned)policy);
+}
+
+uint8_t Motor_GetDefaultSpeed(void) { return 100; }
+void Motor_TraceCommand(uint32_t arrivalUs) { (void)arrivalUs; }
+void Motor_TraceEnd(void) {}
+
+void Msg_Send(MsgId_t id, ...)
+{
+    Append(rec->msgs, sizeof(rec->msgs), "%u", (unsigned)id);
+}
+
+void SwTimer_Setup(SwTimer_t *timer, SwTimerCallback_t callback, void *arg)
+{
+    (void)timer;
+    (void)callback;
+    (void)arg;
+}
+
+void SwTimer_Start(SwTimer_t *timer, uint32_t delayMs, uint32_t periodMs)
+{
+    (void)timer;
+    (void)periodMs;
+    Append(rec->timer, sizeof(rec->timer), "Start(%u)", delayMs);
+}
+
+void SwTimer_Stop(SwTimer_t *timer)
+{
+    (void)timer;
+    Append(rec->timer, sizeof(rec->timer), "Stop");
+}
+
+void UART_SendString(const char *str) { (void)str; }
+
+bool Events_Post(EventSource_t source, CarEvent_t event, uint16_t arg)
+{
+    (void)source;
+    (void)event;
+    (void)arg;
+    return true;
+}
+
+bool Events_Get(QueuedEvent_t *out) { (void)out; return false; }
+void Prof_Record(ProfPoint_t point, uint32_t us) { (void)point; (void)us; }
+
+// --------------------------------------------
+// Reference: the switch handlers before the matrix
+// --------------------------------------------
+
+static void Ref_EnterState(Outcome_t *o, CarState_t newState)
+{
+    o->state = newState;
+
+    switch (newState) {
+        case STATE_IDLE:
+            Append(o->motor, sizeof(o->motor), "Stop");
+            Append(o->msgs, sizeof(o->msgs), "%u", MSG_STATE_IDLE);
+            break;
+        case STATE_FORWARD:
+            Append(o->motor, sizeof(o->motor), "Forward(%u)", TEST_SPEED);
+            Append(o->msgs, sizeof(o->msgs), "%u", MSG_STATE_FORWARD);
+            break;
+        case STATE_BACKWARD:
+            Append(o->motor, sizeof(o->motor), "Backward(%u)", TEST_SPEED);
+            Append(o->msgs, sizeof(o->msgs), "%u", MSG_STATE_BACKWARD);
+            break;
+        case STATE_LEFT:
+            Append(o->msgs, sizeof(o->msgs), "%u", MSG_PIVOT_LEFT);
+            Append(o->motor, sizeof(o->motor), "TurnLeft(%u)", TEST_SPEED);
+            Append(o->timer, sizeof(o->timer), "Start(%u)", TURN_DURATION_MS);
+            break;
+        case STATE_RIGHT:
+            Append(o->msgs, sizeof(o->msgs), "%u", MSG_PIVOT_RIGHT);
+            Append(o->motor, sizeof(o->motor), "TurnRight(%u)", TEST_SPEED);
+            Append(o->timer, sizeof(o->timer), "Start(%u)", TURN_DURATION_MS);
+            break;
+        default:
+            break;
+    }
+}
+
+static void Ref_Handle(Outcome_t *o, CarState_t state, CarEvent_t event)
+{
+    switch (state) {
+        case STATE_IDLE:
+            switch (event) {
+                case EVENT_CMD_FORWARD:  Ref_EnterState(o, STATE_FORWARD); break;
+                case EVENT_CMD_BACKWARD: Ref_EnterState(o, STATE_BACKWARD); break;
+                case EVENT_CMD_LEFT:     Ref_EnterState(o, STATE_LEFT); break;
+                case EVENT_CMD_RIGHT:    Ref_EnterState(o, STATE_RIGHT); break;
+                default: break;
+            }
+            break;
+        case STATE_FORWARD:
+            switch (event) {
+                case EVENT_OBSTACLE:     Ref_EnterState(o, STATE_IDLE); break;
+                case EVENT_CMD_STOP:     Ref_EnterState(o, STATE_IDLE); break;
+                case EVENT_CMD_BACKWARD: Ref_EnterState(o, STATE_BACKWARD); break;
+                case EVENT_CMD_LEFT:     Ref_EnterState(o, STATE_LEFT); break;
+                case EVENT_CMD_RIGHT:    Ref_EnterState(o, STATE_RIGHT); break;
+                case EVENT_CMD_FORWARD:
+                    Append(o->motor, sizeof(o->motor), "Forward(%u)", TEST_SPEED);
+                    break;
+                default: break;
+            }
+            break;
+        case STATE_BACKWARD:
+            switch (event) {
+                case EVENT_OBSTACLE:     Ref_EnterState(o, STATE_IDLE); break;
+                case EVENT_CMD_STOP:     Ref_EnterState(o, STATE_IDLE); break;
+                case EVENT_CMD_FORWARD:  Ref_EnterState(o, STATE_FORWARD); break;
+                case EVENT_CMD_LEFT:     Ref_EnterState(o, STATE_LEFT); break;
+                case EVENT_CMD_RIGHT:    Ref_EnterState(o, STATE_RIGHT); break;
+                case EVENT_CMD_BACKWARD:
+                    Append(o->motor, sizeof(o->motor), "Backward(%u)", TEST_SPEED);
+                    break;
+                default: break;
+            }
+            break;
+        case STATE_LEFT:
+        case STATE_RIGHT:
+            switch (event) {
+                case EVENT_CMD_STOP:     Ref_EnterState(o, STATE_IDLE); break;
+                case EVENT_CMD_FORWARD:  Ref_EnterState(o, STATE_FORWARD); break;
+                case EVENT_CMD_BACKWARD: Ref_EnterState(o, STATE_BACKWARD); break;
+                case EVENT_CMD_LEFT:
+                    if (state == STATE_LEFT) {
+                        Append(o->motor, sizeof(o->motor), "TurnLeft(%u)", TEST_SPEED);
+                    } else {
+                        Ref_EnterState(o, STATE_LEFT);
+                    }
+                    break;
+                case EVENT_CMD_RIGHT:
+                    if (state == STATE_RIGHT) {
+                        Append(o->motor, sizeof(o->motor), "TurnRight(%u)", TEST_SPEED);
+                    } else {
+                        Ref_EnterState(o, STATE_RIGHT);
+                    }
+                    break;
+                case EVENT_TURN_COMPLETE:
+                    // Was the turn-complete flag check in FSM_Update()
+                    Append(o->motor, sizeof(o->motor), "Stop");
+                    Append(o->msgs, sizeof(o->msgs), "%u", MSG_TURN_COMPLETE);
+                    o->state = STATE_IDLE;
+                    break;
+                default: break;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Expected outcome of one event: the old handlers, then the
+ *        changes made on purpose since
+ */
+static void Reference(Outcome_t *o, CarState_t state, CarEvent_t event)
+{
+    memset(o, 0, sizeof(*o));
+    o->state = state;
+    Ref_Handle(o, state, event);
+
+    // Leaving a turn early stops its timer (transition matrix, exit action)
+    if ((state == STATE_LEFT || state == STATE_RIGHT) && o->state != state) {
+        char started[sizeof(o->timer)];
+        strcpy(started, o->timer);
+        o->timer[0] = '\0';
+        Append(o->timer, sizeof(o->timer), "Stop");
+        if (started[0] != '\0') {
+            Append(o->timer, sizeof(o->timer), "%s", started);
+        }
+    }
+
+    // Obstacle stops brake (OBSTACLE_STOP_POLICY) before IDLE's Motor_Stop()
+    if (event == EVENT_OBSTACLE && o->state != state) {
+        char rest[sizeof(o->motor)];
+        strcpy(rest, o->motor);
+        o->motor[0] = '\0';
+        Append(o->motor, sizeof(o->motor), "StopWith(%u)", (unsigned)OBSTACLE_STOP_POLICY);
+        Append(o->motor, sizeof(o->motor), "%s", rest);
+    }
+}
+
+static void Print(const char *label, const Outcome_t *o)
+{
+    printf("  %-9s state %-8s motor [%s] msgs [%s] timer [%s]\n", label, FSM_GetStateName(o->state),
+           o->motor, o->msgs, o->timer);
+}
+
+int main(int argc, char **argv)
+{
+    bool verbose = (argc > 1 && strcmp(argv[1], "-v") == 0);
+    int pairs = 0, failures = 0;
+
+    if (argc > 1 && !verbose) {
+        fprintf(stderr, "usage: fsm_check [-v]\n");
+        return 1;
+    }
+
+    for (int s = 0; s < STATE_COUNT; s++) {
+        for (int e = 0; e < EVENT_COUNT; e++) {
+            Outcome_t actual, expected;
+
+            memset(&actual, 0, sizeof(actual));
+            rec = &actual;
+            g_currentState = (CarState_t)s;
+            g_currentSpeed = TEST_SPEED;
+            FSM_ProcessEvent((CarEvent_t)e);
+            actual.state = g_currentState;
+
+            Reference(&expected, (CarState_t)s, (CarEvent_t)e);
+
+            bool match = actual.state == expected.state && strcmp(actual.motor, expected.motor) == 0 &&
+                         strcmp(actual.msgs, expected.msgs) == 0 && strcmp(actual.timer, expected.timer) == 0;
+            pairs++;
+            if (!match || verbose) {
+                printf("%s %s + event %d\n", match ? "ok  " : "FAIL", FSM_GetStateName((CarState_t)s), e);
+                Print("matrix", &actual);
+                Print("expected", &expected);
+            }
+            failures += !match;
+        }
+    }
+
+    printf("%d/%d state/event pairs match\n", pairs - failures, pairs);
+    return failures ? 1 : 0;
+}
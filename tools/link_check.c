@@ -0,0 +1,224 @@
+/**
+ * Host-side check of the command link (see source/bluetooth.c, proto.c)
+ *
+ * Builds the firmware's bluetooth.c and proto.c against a stand-in UART0
+ * and RX DMA: each burst is written into the RX ring the way the DMA
+ * does, then the idle-line interrupt runs. The checks replay what the
+ * link does in the field and look at Bluetooth_GetCommand() and at the
+ * ISR STOP fast path (Motor_EmergencyStop calls):
+ *   - a binary frame still goes through (also split over two bursts)
+ *   - a frame cut off before its closing 0x00, then an ASCII 'S' after
+ *     a pause, is a STOP (ASCII keeps working as the fallback) and the
+ *     ISR cuts the motors for it
+ *   - a "frame" longer than any valid one gives the link back to ASCII
+ *
+ * C, not C++ like most tools: bluetooth.c initializes its lookup table
+ * with array range designators, which g++ does not accept.
+ *
+ * Build:  gcc -std=gnu99 -Itools/stubs -o link_check tools/link_check.c
+ * Usage:  link_check
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+// --------------------------------------------
+// Register and SDK stand-ins for bluetooth.c
+// --------------------------------------------
+
+typedef struct { uint8_t S1, C1, C2, C3, C5, D; } UartRegs_t;
+static UartRegs_t uart0;
+#define UART0   (&uart0)
+
+#define UART0_S1_IDLE_MASK  0x10U
+#define UART0_S1_OR_MASK    0x08U
+#define UART0_S1_NF_MASK    0x04U
+#define UART0_S1_FE_MASK    0x02U
+#define UART0_S1_PF_MASK    0x01U
+#define UART_S1_RDRF_MASK   0x20U
+#define UART0_C1_ILT_MASK   0x04U
+#define UART0_C2_ILIE_MASK  0x10U
+#define UART0_C2_RIE_MASK   0x20U
+#define UART_C2_RIE_MASK    0x20U
+#define UART0_C3_ORIE_MASK  0x08U
+#define UART0_C3_NEIE_MASK  0x04U
+#define UART0_C3_FEIE_MASK  0x02U
+#define UART0_C3_PEIE_MASK  0x01U
+#define UART0_C5_RDMAE_MASK 0x20U
+
+typedef enum { UART0_IRQn = 12 } IRQn_Type;
+static inline void NVIC_SetPriority(IRQn_Type irq, uint32_t priority) { (void)irq; (void)priority; }
+static inline void NVIC_EnableIRQ(IRQn_Type irq) { (void)irq; }
+static inline uint32_t DisableGlobalIRQ(void) { return 0; }
+static inline void EnableGlobalIRQ(uint32_t primask) { (void)primask; }
+
+// RX DMA: the tool writes the ring itself and counts the bytes
+static uint32_t dmaWritten = 0;
+
+typedef struct { int unused; } DMA_Type, DMAMUX_Type;
+typedef struct { int unused; } dma_transfer_config_t;
+enum { kDMA_PeripheralToMemory, kDMA_ModuloDisable, kDMA_Modulo64Bytes, kDMA_TransactionsDoneFlag,
+       kDmaRequestMux0UART0Rx };
+static DMA_Type dma0;
+static DMAMUX_Type dmamux0;
+#define DMA0    (&dma0)
+#define DMAMUX0 (&dmamux0)
+
+static inline void DMAMUX_Init(DMAMUX_Type *base) { (void)base; }
+static inline void DMAMUX_SetSource(DMAMUX_Type *base, uint32_t ch, int src) { (void)base; (void)ch; (void)src; }
+static inline void DMAMUX_EnableChannel(DMAMUX_Type *base, uint32_t ch) { (void)base; (void)ch; }
+static inline void DMA_Init(DMA_Type *base) { (void)base; }
+static inline void DMA_ResetChannel(DMA_Type *base, uint32_t ch) { (void)base; (void)ch; }
+static inline void DMA_PrepareTransfer(dma_transfer_config_t *config, void *src, uint32_t srcWidth, void *dst,
+                                       uint32_t dstWidth, uint32_t bytes, int type)
+{
+    (void)config; (void)src; (void)srcWidth; (void)dst; (void)dstWidth; (void)bytes; (void)type;
+}
+static inline void DMA_SetTransferConfig(DMA_Type *base, uint32_t ch, const dma_transfer_config_t *config)
+{
+    (void)base; (void)ch; (void)config;
+}
+static inline void DMA_SetModulo(DMA_Type *base, uint32_t ch, int src, int dst) { (void)base; (void)ch; (void)src; (void)dst; }
+static inline void DMA_EnableChannelRequest(DMA_Type *base, uint32_t ch) { (void)base; (void)ch; }
+static inline void DMA_DisableChannelRequest(DMA_Type *base, uint32_t ch) { (void)base; (void)ch; }
+static inline void DMA_ClearChannelStatusFlags(DMA_Type *base, uint32_t ch, int mask) { (void)base; (void)ch; (void)mask; }
+static inline void DMA_SetTransferSize(DMA_Type *base, uint32_t ch, uint32_t bytes) { (void)base; (void)ch; (void)bytes; }
+static uint32_t DMA_GetRemainingBytes(DMA_Type *base, uint32_t ch);
+
+// Time: set by the tool, one character time per byte
+static uint32_t nowUs = 1000000U;
+#define TIMEBASE_H
+static inline uint32_t Timebase_GetUs(void) { return nowUs; }
+static inline uint32_t Timebase_ElapsedUs(uint32_t startUs) { return nowUs - startUs; }
+
+// Same link code as the firmware
+#include "../source/proto.c"
+#include "../source/bluetooth.c"
+
+static uint32_t DMA_GetRemainingBytes(DMA_Type *base, uint32_t ch)
+{
+    (void)base;
+    (void)ch;
+    return RX_DMA_BCR_START - (dmaWritten - rxDmaBase);
+}
+
+// --------------------------------------------
+// Stubs for everything else bluetooth.c calls
+// --------------------------------------------
+
+static int emergencyStops = 0;
+
+void Motor_EmergencyStop(void) { emergencyStops++; }
+uint8_t Motor_GetDefaultSpeed(void) { return 100; }
+bool Events_Post(EventSource_t source, CarEvent_t event, uint16_t arg)
+{
+    (void)source;
+    (void)event;
+    (void)arg;
+    return true;
+}
+void UART_SendString(const char *str) { (void)str; }
+void UART_SendNumber(uint32_t num) { (void)num; }
+void UART_SendCenti(uint32_t centi) { (void)centi; }
+void UART_TxIRQHandler(void) {}
+void Prof_Record(ProfPoint_t point, uint32_t us) { (void)point; (void)us; }
+
+// --------------------------------------------
+// Link replay
+// --------------------------------------------
+
+/**
+ * @brief One burst after pauseUs of silence: DMA writes, then idle line
+ */
+static void Receive(uint32_t pauseUs, const uint8_t *bytes, uint32_t len)
+{
+    nowUs += pauseUs;
+    for (uint32_t i = 0; i < len; i++) {
+        rxBuffer[dmaWritten++ & RX_BUFFER_MASK] = bytes[i];
+        nowUs += UART_CHAR_TIME_US;
+    }
+    nowUs += UART_CHAR_TIME_US;  // Idle character
+    uart0.S1 = UART0_S1_IDLE_MASK;
+    UART0_IRQHandler();
+}
+
+/**
+ * @brief Everything the main loop gets from the buffered bytes, in order
+ */
+static int ReadAll(BluetoothCommand *out, int max)
+{
+    int n = 0;
+    BluetoothCommand cmd;
+
+    while ((cmd = Bluetooth_GetCommand()) != CMD_NONE && n < max) {
+        out[n++] = cmd;
+    }
+    return n;
+}
+
+static int failures = 0;
+
+static void ExpectIsrStops(const char *name, int want)
+{
+    bool ok = (emergencyStops == want);
+
+    printf("%s %s: %d ISR stops, expected %d\n", ok ? "ok  " : "FAIL", name, emergencyStops, want);
+    failures += !ok;
+}
+
+static void Expect(const char *name, BluetoothCommand want)
+{
+    BluetoothCommand got[8];
+    int n = ReadAll(got, 8);
+    bool ok = (want == CMD_NONE) ? (n == 0) : (n == 1 && got[0] == want);
+
+    printf("%s %s: got", ok ? "ok  " : "FAIL", name);
+    for (int i = 0; i < n; i++) {
+        printf(" %d", got[i]);
+    }
+    printf("%s, expected %d\n", (n == 0) ? " nothing" : "", want);
+    failures += !ok;
+}
+
+int main(void)
+{
+    uint8_t frame[PROTO_ENCODED_MAX(8)];
+    const uint8_t forward[] = {PROTO_VERSION, CMD_FORWARD, 0};
+    uint16_t frameLen = Proto_EncodeFrame(forward, sizeof(forward), frame);
+    const uint8_t stop = 'S';
+    uint8_t junk[40];
+
+    Bluetooth_Init();
+    uart0.C2 |= UART0_C2_ILIE_MASK;
+
+    // Valid frame, one burst and split over two (HC-05 packets)
+    Receive(100000U, frame, frameLen);
+    Expect("frame", CMD_FORWARD);
+    Receive(100000U, frame, 3);
+    Receive(5000U, frame + 3, frameLen - 3U);
+    Expect("frame in two bursts", CMD_FORWARD);
+    ExpectIsrStops("frames", 0);
+
+    // Link lost after the first bytes of a frame, then an ASCII STOP
+    Receive(100000U, frame, 3);
+    Expect("truncated frame", CMD_NONE);
+    Receive(500000U, &stop, 1);
+    ExpectIsrStops("truncated frame, then 'S'", 1);
+    Expect("truncated frame, then 'S'", CMD_STOP);
+    Bluetooth_TakeIsrStop();
+
+    // Stray 0x00 and no closing one: ASCII again past the longest frame
+    memset(junk, 0x01, sizeof(junk));
+    junk[0] = PROTO_DELIMITER;
+    Receive(100000U, junk, sizeof(junk));
+    Expect("oversized frame", CMD_NONE);
+    Receive(0U, junk + 1, PROTO_MAX_ENCODED_LEN + 1U - (sizeof(junk) - 1U));
+    Receive(0U, &stop, 1);
+    ExpectIsrStops("oversized frame, then 'S'", 2);
+    Expect("oversized frame, then 'S'", CMD_STOP);
+
+    printf("%s\n", failures ? "link check FAILED" : "link check passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,217 @@
+/**
+ * Host-side count of the Bluetooth link bytes the motor logs cost (see
+ * source/log.h)
+ *
+ * Builds the firmware's motor.c twice, once on each log backend:
+ *   LOG_BACKEND_BLUETOOTH  the old behaviour, logs share UART0 (HC-05)
+ *   LOG_BACKEND_UART1      logs go to the UART1 debug port
+ * and records the bytes each one writes to UART0 and UART1 for one
+ * motion command (the Motor_* call the FSM makes for F/B/L/R/S), at each
+ * speed setting the app can send. The difference on UART0 is what the
+ * link saves per command; airtime at 9600 baud 8N1 (1.04ms per byte).
+ *
+ * The motor driver's registers and SDK calls are stand-ins below (they
+ * only need to accept the writes), the headers come from tools/stubs/.
+ *
+ * Build:  g++ -std=c++20 -O2 -Itools/stubs -o log_bytes tools/log_bytes.cpp
+ * Usage:  log_bytes [-v]     (-v: print the UART0 text per command)
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+// --------------------------------------------
+// Register and SDK stand-ins for motor.c / log.c
+// --------------------------------------------
+
+struct GpioRegs { uint32_t PSOR, PCOR; };
+struct TpmChannel { uint32_t CnSC, CnV; };
+struct TpmRegs { uint32_t SC, MOD; TpmChannel CONTROLS[6]; };
+struct SimRegs { uint32_t SCGC6, SOPT2; };
+struct PortRegs { uint32_t PCR[32]; };
+struct UartRegs { uint8_t D; };
+
+static GpioRegs gpioB, gpioC;
+static TpmRegs tpm0;
+static SimRegs sim;
+static PortRegs portA, portB, portC, portE;
+static UartRegs uart1Regs;
+
+#define GPIOB   (&gpioB)
+#define GPIOC   (&gpioC)
+#define TPM0    (&tpm0)
+#define SIM     (&sim)
+#define PORTA   (&portA)
+#define PORTB   (&portB)
+#define PORTC   (&portC)
+#define PORTE   (&portE)
+#define UART1   (&uart1Regs)
+
+#define SIM_SCGC6_TPM0_MASK     (1U << 24)
+#define SIM_SOPT2_TPMSRC_MASK   (3U << 24)
+#define SIM_SOPT2_TPMSRC(x)     ((uint32_t)(x) << 24)
+#define TPM_SC_PS(x)            ((uint32_t)(x))
+#define TPM_SC_CMOD(x)          ((uint32_t)(x) << 3)
+#define TPM_SC_TOIE_MASK        (1U << 6)
+#define TPM_SC_TOF_MASK         (1U << 7)
+#define TPM_CnSC_MSB_MASK       (1U << 5)
+#define TPM_CnSC_ELSB_MASK      (1U << 3)
+
+enum IRQn_Type { TPM0_IRQn = 17 };
+static inline void NVIC_SetPriority(IRQn_Type, uint32_t) {}
+static inline void NVIC_EnableIRQ(IRQn_Type) {}
+static inline uint32_t DisableGlobalIRQ(void) { return 0; }
+static inline void EnableGlobalIRQ(uint32_t) {}
+
+enum clock_ip_name_t { kCLOCK_PortA, kCLOCK_PortB, kCLOCK_PortC, kCLOCK_PortE };
+enum clock_name_t { kCLOCK_PllFllSelClk };
+static inline void CLOCK_EnableClock(clock_ip_name_t) {}
+static inline uint32_t CLOCK_GetFreq(clock_name_t) { return 48000000U; }
+static inline uint32_t CLOCK_GetBusClkFreq(void) { return 24000000U; }
+
+enum port_mux_t { kPORT_MuxAsGpio = 1, kPORT_MuxAlt3 = 3 };
+static inline void PORT_SetPinMux(PortRegs *, uint32_t, port_mux_t) {}
+
+enum gpio_pin_direction_t { kGPIO_DigitalInput, kGPIO_DigitalOutput };
+struct gpio_pin_config_t {
+    gpio_pin_direction_t pinDirection;
+    uint8_t outputLogic;
+};
+static inline void GPIO_PinInit(GpioRegs *, uint32_t, const gpio_pin_config_t *) {}
+
+// Bytes on each wire
+static std::string uart0Bytes;      // Bluetooth link (uart.c)
+static std::string uart1Bytes;      // Debug port (fsl_uart)
+
+struct uart_config_t {
+    uint32_t baudRate_Bps;
+    bool enableTx;
+    bool enableRx;
+};
+static inline void UART_GetDefaultConfig(uart_config_t *) {}
+static inline int UART_Init(UartRegs *, const uart_config_t *, uint32_t) { return 0; }
+static inline void UART_WriteBlocking(UartRegs *, const uint8_t *data, size_t length)
+{
+    uart1Bytes.append(reinterpret_cast<const char *>(data), length);
+}
+
+// Time only feeds the profiler here: no PIT on the host
+#define TIMEBASE_H
+static inline uint32_t Timebase_GetUs(void) { return 0; }
+static inline uint32_t Timebase_ElapsedUs(uint32_t startUs) { return 0U - startUs; }
+
+// --------------------------------------------
+// Firmware headers and the modules both builds share
+// --------------------------------------------
+
+#include "../source/fmt.c"
+#include "../source/motion.c"
+#include "../source/prof.h"
+#include "../source/uart.h"
+
+void UART_SendString(const char *str) { uart0Bytes += str; }
+
+void UART_SendNumber(uint32_t num)
+{
+    char buf[FMT_U32_MAX_LEN];
+    uart0Bytes.append(buf, Fmt_U32(buf, num));
+}
+
+void Prof_Record(ProfPoint_t, uint32_t) {}
+
+// One motor driver per log backend: log.h and motor.h are read again in
+// each namespace so the declarations (and LOG_BACKEND) land there too
+namespace bt {
+#define LOG_BACKEND LOG_BACKEND_BLUETOOTH
+#include "../source/log.c"
+#include "../source/motor.c"
+}  // namespace bt
+
+namespace dbg {
+#undef LOG_H
+#undef MOTOR_H
+#undef LOG_BACKEND
+#define LOG_BACKEND LOG_BACKEND_UART1
+#include "../source/log.c"
+#include "../source/motor.c"
+}  // namespace dbg
+
+namespace {
+
+struct Backend {
+    const char *name;
+    void (*forward)(uint8_t);
+    void (*backward)(uint8_t);
+    void (*turnLeft)(uint8_t);
+    void (*turnRight)(uint8_t);
+    void (*stop)(void);
+};
+
+const Backend kBackends[2] = {
+    {"bluetooth", bt::Motor_Forward, bt::Motor_Backward, bt::Motor_TurnLeft, bt::Motor_TurnRight, bt::Motor_Stop},
+    {"uart1", dbg::Motor_Forward, dbg::Motor_Backward, dbg::Motor_TurnLeft, dbg::Motor_TurnRight,
+     dbg::Motor_Stop},
+};
+
+struct Count {
+    size_t uart0;
+    size_t uart1;
+    std::string text;
+};
+
+Count Run(const Backend &b, char cmd, uint8_t speed)
+{
+    uart0Bytes.clear();
+    uart1Bytes.clear();
+    switch (cmd) {
+    case 'F': b.forward(speed); break;
+    case 'B': b.backward(speed); break;
+    case 'L': b.turnLeft(speed); break;
+    case 'R': b.turnRight(speed); break;
+    default:  b.stop(); break;
+    }
+    return {uart0Bytes.size(), uart1Bytes.size(), uart0Bytes};
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    bool verbose = (argc > 1 && std::strcmp(argv[1], "-v") == 0);
+
+    if (argc > 1 && !verbose) {
+        std::fprintf(stderr, "usage: log_bytes [-v]\n");
+        return 1;
+    }
+
+    std::printf("%-4s %6s %12s %12s %12s %8s %9s\n", "cmd", "speed", "bt: UART0", "uart1: UART0", "uart1: UART1",
+                "saved", "airtime");
+    for (char cmd : {'F', 'B', 'L', 'R', 'S'}) {
+        for (uint8_t speed : {10, 50, 100}) {
+            if (cmd == 'S' && speed != 100) {
+                continue;  // STOP has no speed
+            }
+            Count before = Run(kBackends[0], cmd, speed);
+            Count after = Run(kBackends[1], cmd, speed);
+            size_t saved = before.uart0 - after.uart0;
+
+            std::printf("%-4c %5u%% %12zu %12zu %12zu %8zu %6.1f ms\n", cmd, speed, before.uart0, after.uart0,
+                        after.uart1, saved, saved * 10 * 1000.0 / 9600);
+            if (verbose) {
+                std::printf("     UART0 with the bluetooth backend: \"");
+                for (char c : before.text) {
+                    std::printf((c == '\r') ? "\\r" : (c == '\n') ? "\\n" : "%c", c);
+                }
+                std::printf("\"\n");
+            }
+            if (after.uart0 != 0 || after.uart1 != before.uart0) {
+                std::printf("     expected every log byte to move from UART0 to UART1\n");
+                return 1;
+            }
+        }
+    }
+    std::printf("saved: UART0 bytes per command; airtime at 9600 baud 8N1\n");
+    return 0;
+}
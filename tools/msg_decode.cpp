@@ -0,0 +1,155 @@
+/**
+ * Host-side decoder for compact telemetry (see source/messages.h)
+ *
+ * Reads the raw byte stream from the car (serial port / rfcomm device or
+ * a capture file) and prints the expanded text. Plain text bytes are
+ * passed through unchanged, so the boot banner still shows up.
+ *
+ * Build:  g++ -std=c++17 -O2 -o msg_decode tools/msg_decode.cpp
+ * Usage:  msg_decode [-s] [file]      (default: stdin)
+ *           -s  print bytes received vs. bytes expanded at the end
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "../source/messages.h"
+
+namespace {
+
+const char *const kMessageText[MSG_COUNT] = {
+#define MESSAGE_TEXT_ENTRY(id, text) text,
+    MESSAGE_LIST(MESSAGE_TEXT_ENTRY)
+#undef MESSAGE_TEXT_ENTRY
+};
+
+struct Reader {
+    std::FILE *in;
+    uint64_t bytesIn = 0;
+
+    bool Byte(uint8_t &out)
+    {
+        int c = std::fgetc(in);
+        if (c == EOF) {
+            return false;
+        }
+        bytesIn++;
+        out = static_cast<uint8_t>(c);
+        return true;
+    }
+
+    bool Varint(uint32_t &out)
+    {
+        uint8_t b;
+        out = 0;
+        for (unsigned shift = 0; shift < 35; shift += 7) {
+            if (!Byte(b)) {
+                return false;
+            }
+            out |= static_cast<uint32_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) {
+                return true;
+            }
+        }
+        return false;  // Malformed: more than 5 bytes
+    }
+};
+
+// Expand one compact message; false on truncated input
+bool Expand(Reader &reader, const char *fmt, std::string &out)
+{
+    for (; *fmt; fmt++) {
+        if (*fmt != '%' || fmt[1] == '\0') {
+            out += *fmt;
+            continue;
+        }
+
+        fmt++;
+        uint32_t value;
+        switch (*fmt) {
+            case 'u':
+                if (!reader.Varint(value)) return false;
+                out += std::to_string(value);
+                break;
+
+            case 'c': {
+                if (!reader.Varint(value)) return false;
+                char frac[4];
+                std::snprintf(frac, sizeof frac, "%02u", static_cast<unsigned>(value % 100));
+                out += std::to_string(value / 100) + "." + frac;
+                break;
+            }
+
+            case 's':
+                if (!reader.Varint(value)) return false;
+                while (value--) {
+                    uint8_t b;
+                    if (!reader.Byte(b)) return false;
+                    out += static_cast<char>(b);
+                }
+                break;
+
+            case '%':
+                out += '%';
+                break;
+
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    bool stats = false;
+    const char *path = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "-s") == 0) {
+            stats = true;
+        } else {
+            path = argv[i];
+        }
+    }
+
+    Reader reader{path ? std::fopen(path, "rb") : stdin};
+    if (!reader.in) {
+        std::perror(path);
+        return 1;
+    }
+
+    uint64_t bytesOut = 0;
+    uint8_t b;
+    while (reader.Byte(b)) {
+        std::string text;
+
+        if (b < MSG_WIRE_BASE) {
+            text = static_cast<char>(b);
+        } else if (b - MSG_WIRE_BASE < MSG_COUNT) {
+            if (!Expand(reader, kMessageText[b - MSG_WIRE_BASE], text)) {
+                break;
+            }
+        } else {
+            char unknown[16];
+            std::snprintf(unknown, sizeof unknown, "<?%02X>", b);
+            text = unknown;
+        }
+
+        bytesOut += text.size();
+        std::fwrite(text.data(), 1, text.size(), stdout);
+        std::fflush(stdout);
+    }
+
+    if (stats && reader.bytesIn > 0) {
+        std::fprintf(stderr, "\n%llu bytes received, %llu bytes expanded (%.1fx)\n",
+                     static_cast<unsigned long long>(reader.bytesIn),
+                     static_cast<unsigned long long>(bytesOut),
+                     static_cast<double>(bytesOut) / static_cast<double>(reader.bytesIn));
+    }
+    return 0;
+}
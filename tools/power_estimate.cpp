@@ -0,0 +1,107 @@
+/**
+ * Host-side MCU current estimate from the 'I' power residency line
+ *
+ * Scans decoded telemetry (msg_decode output or a verbose capture) for
+ * "Power: run R ms, wait W ms, vlps V ms" and weights each state by the
+ * KL25Z datasheet typical supply current (48 MHz core, 24 MHz bus, 3 V,
+ * 25 C). MCU only - motors, HC-05 and sensors are not included.
+ *
+ * VLPS time is compared with the same time spent in Wait (the gain).
+ * For a capture from a build without VLPS, -v moves a share of the
+ * Wait time to VLPS (the share spent parked) to project the gain.
+ *
+ * Build:  g++ -std=c++17 -O2 -o power_estimate tools/power_estimate.cpp
+ * Usage:  msg_decode capture.bin | power_estimate [-c mAh] [-v pct]
+ *           -c  battery capacity used for the runtime estimate (default 2000)
+ *           -v  % of the Wait time to count as VLPS (projection)
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+// KL25 datasheet, IDD typicals (mA)
+constexpr double kRunMa = 6.1;      // RUN, all peripheral clocks off, from flash
+constexpr double kWaitMa = 3.7;     // WAIT, core clock gated
+constexpr double kVlpsCoreMa = 0.0027;  // VLPS, LPO + LPTMR
+// Kept running in VLPS so UART0 receives and wakes the MCU (power.h);
+// low-power mode peripheral adders, approximate
+constexpr double kOscStopMa = 0.22;     // OSCERCLK in stop (EREFSTEN), crystal low-power mode
+constexpr double kUart0StopMa = 0.07;   // UART0 clocked in VLPS
+constexpr double kVlpsMa = kVlpsCoreMa + kOscStopMa + kUart0StopMa;
+
+struct Residency {
+    unsigned long runMs = 0;
+    unsigned long waitMs = 0;
+    unsigned long vlpsMs = 0;
+};
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    double capacityMah = 2000.0;
+    double projectPct = -1.0;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            capacityMah = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "-v") == 0 && i + 1 < argc) {
+            projectPct = std::atof(argv[++i]);
+        } else {
+            std::fprintf(stderr, "usage: %s [-c mAh] [-v pct] < telemetry\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // Counters are cumulative since reset: the last report wins
+    Residency last;
+    bool found = false;
+    char line[256];
+    while (std::fgets(line, sizeof line, stdin)) {
+        Residency r;
+        const char *p = std::strstr(line, "Power: ");
+        if (p && std::sscanf(p, "Power: run %lu ms, wait %lu ms, vlps %lu ms",
+                             &r.runMs, &r.waitMs, &r.vlpsMs) == 3) {
+            last = r;
+            found = true;
+        }
+    }
+
+    if (!found) {
+        std::fprintf(stderr, "no \"Power:\" line found (send 'I' to the car)\n");
+        return 1;
+    }
+
+    if (projectPct >= 0.0) {
+        unsigned long moved = static_cast<unsigned long>(last.waitMs * projectPct / 100.0);
+        last.waitMs -= moved;
+        last.vlpsMs += moved;
+        std::printf("projected  %.0f%% of wait as vlps\n", projectPct);
+    }
+
+    double total = static_cast<double>(last.runMs + last.waitMs + last.vlpsMs);
+    if (total <= 0.0) {
+        std::fprintf(stderr, "empty residency counters\n");
+        return 1;
+    }
+
+    double run = last.runMs / total;
+    double wait = last.waitMs / total;
+    double vlps = last.vlpsMs / total;
+    double avgMa = run * kRunMa + wait * kWaitMa + vlps * kVlpsMa;
+
+    std::printf("observed   %.1f s\n", total / 1000.0);
+    std::printf("run        %5.1f %%  (%.2f mA)\n", run * 100.0, kRunMa);
+    std::printf("wait       %5.1f %%  (%.2f mA)\n", wait * 100.0, kWaitMa);
+    std::printf("vlps       %5.1f %%  (%.4f mA)\n", vlps * 100.0, kVlpsMa);
+    std::printf("average    %.2f mA (always-run: %.2f mA, %.0f%% saved)\n",
+                avgMa, kRunMa, (1.0 - avgMa / kRunMa) * 100.0);
+    double waitOnlyMa = avgMa + vlps * (kWaitMa - kVlpsMa);
+    std::printf("vlps gain  %.2f mA vs. wait only (%.2f mA, %.0f%% saved)\n",
+                waitOnlyMa - avgMa, waitOnlyMa, (1.0 - avgMa / waitOnlyMa) * 100.0);
+    std::printf("MCU only   %.0f h on %.0f mAh\n", capacityMah / avgMa, capacityMah);
+    return 0;
+}
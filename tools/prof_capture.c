@@ -0,0 +1,120 @@
+/**
+ * Reference profiler dump for tools/prof_report (see source/prof.h)
+ *
+ * Builds the firmware's prof.c, proto.c and msg.c on the host, records a
+ * fixed reference load into the real histograms and writes what the car
+ * sends for 'I' followed by 'Z': info text, then one binary frame per
+ * point. Replaying it with budgets is the latency check that runs without
+ * a board; a live capture (same format) replaces it when one is at hand.
+ *
+ * The load (fixed seed, so dumps compare) follows the firmware's timing:
+ * a burst ISR per command plus the STOP fast path now and then, the
+ * TPM2 tick, and commands that wait for the idle line (two character
+ * times at 9600 baud) and for the next pass of the commands task before
+ * the PWM write. Change it together with the code it stands for.
+ *
+ * C, not C++ like most tools: prof.c names its points with array
+ * designators, which g++ does not accept.
+ *
+ * Build:  gcc -std=gnu99 -Itools/stubs -o prof_capture tools/prof_capture.c
+ * Usage:  prof_capture [file]      (default: stdout)
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+// Durations are made up below, the timebase is never read
+#define TIMEBASE_H
+static inline uint32_t Timebase_GetUs(void) { return 0; }
+static inline uint32_t Timebase_ElapsedUs(uint32_t startUs) { return 0U - startUs; }
+
+// Same profiler and framing code as the firmware
+#include "../source/fmt.c"
+#include "../source/msg.c"
+#include "../source/proto.c"
+#include "../source/prof.c"
+
+#define CHAR_TIME_US    1042U   // 10 bits at 9600 baud (bluetooth.c)
+
+static FILE *out;
+
+void UART_SendBuffer(const uint8_t *data, uint32_t len)
+{
+    fwrite(data, 1, len, out);
+}
+
+static const char *const taskName[] = {"commands", "obstacle", "lights", "climate"};
+
+void Scheduler_GetTaskStats(uint8_t index, TaskStats_t *stats)
+{
+    stats->name = (index < sizeof(taskName) / sizeof(taskName[0])) ? taskName[index] : "";
+}
+
+/**
+ * @brief xorshift32, fixed seed
+ */
+static uint32_t Random(uint32_t range)
+{
+    static uint32_t state = 12345U;
+
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state % range;
+}
+
+/**
+ * @brief count samples of base + [0, spread) us
+ */
+static void Load(ProfPoint_t point, uint32_t count, uint32_t base, uint32_t spread)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        Prof_Record(point, base + Random(spread));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    out = (argc > 1) ? fopen(argv[1], "wb") : stdout;
+    if (!out) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    // UART0 idle-line ISR: burst copy, STOP fast path for 1 in 50
+    Load(PROF_ISR_UART0, 5000, 10, 12);
+    Load(PROF_ISR_UART0, 100, 22, 12);
+
+    // TPM2 tick, with a software timer callback now and then
+    Load(PROF_ISR_TIMER, 20000, 5, 6);
+    Load(PROF_ISR_TIMER, 400, 20, 40);
+
+    Load(PROF_FSM_EVENT, 200, 25, 50);
+
+    // Queue wait: usually the same pass, else up to a climate read (5ms)
+    Load(PROF_EVENT_AGE, 180, 20, 200);
+    Load(PROF_EVENT_AGE, 20, 200, 5000);
+
+    // Byte -> idle line (one more character) -> commands task -> PWM
+    Load(PROF_CMD_LATENCY, 150, 2U * CHAR_TIME_US, 2500);
+
+    // Scheduler tasks, in priority order (PROIECT.c)
+    Load(PROF_TASK_FIRST + 0, 50000, 15, 80);
+    Load(PROF_TASK_FIRST + 1, 2000, 100, 300);
+    Load(PROF_TASK_FIRST + 2, 100, 300, 200);
+    Load(PROF_TASK_FIRST + 3, 10, 4000, 1000);
+
+    // What a terminal capture holds: the 'I' text, then the 'Z' frames
+    Msg_Send(MSG_INFO_HEADER);
+    ProfSummary_t latency;
+    Prof_GetSummary(PROF_CMD_LATENCY, &latency);
+    Msg_Send(MSG_INFO_CMD_LATENCY, latency.p50Us, latency.p99Us, latency.maxUs);
+    Msg_Send(MSG_INFO_FOOTER);
+    Prof_Dump();
+
+    if (out != stdout) {
+        fclose(out);
+    }
+    return 0;
+}
@@ -0,0 +1,250 @@
+/**
+ * Host-side report for profiler dumps (see source/prof.h)
+ *
+ * Reads the raw byte stream from the car after a 'Z' command (serial port
+ * / rfcomm device or a capture file), picks out the histogram frames and
+ * prints count, percentiles and max per profiling point. Everything else
+ * in the stream (text, compact telemetry) is skipped; a frame is only
+ * accepted if its CRC matches.
+ *
+ * Percentiles are interpolated inside the log2 bucket that holds them, so
+ * they are estimates within a factor of two (max is exact).
+ *
+ * Budgets: -b point=us (repeatable) fails the run (exit status 2) when a
+ * point's p99 is over budget or the point is missing from the capture.
+ * Replaying a saved capture through it is the host-side latency check,
+ * e.g. -b cmd_latency=20000 for command byte -> motor PWM write;
+ * tools/prof_capture writes a reference dump when there is no board.
+ *
+ * Build:  g++ -std=c++17 -O2 -o prof_report tools/prof_report.cpp
+ * Usage:  prof_report [-b point=us]... [file]      (default: stdin)
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr uint8_t kVersion = 1;
+constexpr uint8_t kFrameType = 'H';
+constexpr unsigned kBuckets = 20;
+
+struct Histogram {
+    std::string name;
+    uint32_t count = 0;
+    uint32_t maxUs = 0;
+    uint32_t buckets[kBuckets] = {};
+};
+
+uint16_t Crc16(const std::vector<uint8_t> &data, size_t len)
+{
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= static_cast<uint16_t>(data[i] << 8);
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+bool CobsDecode(const std::vector<uint8_t> &in, std::vector<uint8_t> &out)
+{
+    out.clear();
+    size_t i = 0;
+    while (i < in.size()) {
+        uint8_t code = in[i++];
+        if (code == 0 || i + code - 1 > in.size()) {
+            return false;
+        }
+        for (uint8_t n = 1; n < code; n++) {
+            out.push_back(in[i++]);
+        }
+        if (code != 0xFF && i < in.size()) {
+            out.push_back(0);
+        }
+    }
+    return true;
+}
+
+struct Cursor {
+    const std::vector<uint8_t> &data;
+    size_t pos;
+    size_t end;
+
+    bool Byte(uint8_t &out)
+    {
+        if (pos >= end) {
+            return false;
+        }
+        out = data[pos++];
+        return true;
+    }
+
+    bool Varint(uint32_t &out)
+    {
+        out = 0;
+        for (unsigned shift = 0; shift < 35; shift += 7) {
+            uint8_t b;
+            if (!Byte(b)) {
+                return false;
+            }
+            out |= static_cast<uint32_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+bool ParseFrame(const std::vector<uint8_t> &payload, uint8_t &point, Histogram &h)
+{
+    if (payload.size() < 4) {
+        return false;
+    }
+    size_t len = payload.size() - 2;
+    uint16_t crc = static_cast<uint16_t>((payload[len] << 8) | payload[len + 1]);
+    if (Crc16(payload, len) != crc) {
+        return false;
+    }
+
+    Cursor c{payload, 0, len};
+    uint8_t version, type, nameLen, used;
+    if (!c.Byte(version) || version != kVersion || !c.Byte(type) || type != kFrameType ||
+        !c.Byte(point) || !c.Byte(nameLen)) {
+        return false;
+    }
+    h.name.clear();
+    for (uint8_t i = 0; i < nameLen; i++) {
+        uint8_t ch;
+        if (!c.Byte(ch)) {
+            return false;
+        }
+        h.name += static_cast<char>(ch);
+    }
+    if (!c.Varint(h.count) || !c.Varint(h.maxUs) || !c.Byte(used)) {
+        return false;
+    }
+    for (uint8_t i = 0; i < used; i++) {
+        uint8_t bucket;
+        uint32_t n;
+        if (!c.Byte(bucket) || bucket >= kBuckets || !c.Varint(n)) {
+            return false;
+        }
+        h.buckets[bucket] = n;
+    }
+    return c.pos == len;
+}
+
+// Value at fraction q of the samples, interpolated inside its log2 bucket
+double Percentile(const Histogram &h, double q)
+{
+    double rank = q * h.count;
+    double seen = 0;
+
+    for (unsigned b = 0; b < kBuckets; b++) {
+        if (h.buckets[b] == 0) {
+            continue;
+        }
+        if (seen + h.buckets[b] >= rank) {
+            if (b == 0) {
+                return 0;
+            }
+            double lo = static_cast<double>(1u << (b - 1));
+            double hi = (b == kBuckets - 1) ? h.maxUs : static_cast<double>(1u << b);
+            if (hi > h.maxUs) {
+                hi = h.maxUs;
+            }
+            double value = lo + (hi - lo) * (rank - seen) / h.buckets[b];
+            return value < lo ? lo : value;
+        }
+        seen += h.buckets[b];
+    }
+    return h.maxUs;
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    const char *path = nullptr;
+    std::map<std::string, uint32_t> budgets;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            const char *spec = argv[++i];
+            const char *eq = std::strchr(spec, '=');
+            if (!eq || eq == spec || eq[1] == '\0') {
+                std::fprintf(stderr, "bad budget '%s' (expected point=us)\n", spec);
+                return 1;
+            }
+            budgets[std::string(spec, eq)] = static_cast<uint32_t>(std::strtoul(eq + 1, nullptr, 10));
+        } else {
+            path = argv[i];
+        }
+    }
+
+    std::FILE *in = path ? std::fopen(path, "rb") : stdin;
+    if (!in) {
+        std::perror(path);
+        return 1;
+    }
+
+    // Last dump wins for each point (histograms are cumulative)
+    std::map<uint8_t, Histogram> points;
+    std::vector<uint8_t> raw, payload;
+    int c;
+    while ((c = std::fgetc(in)) != EOF) {
+        if (c != 0) {
+            raw.push_back(static_cast<uint8_t>(c));
+            continue;
+        }
+        Histogram h;
+        uint8_t point;
+        if (!raw.empty() && CobsDecode(raw, payload) && ParseFrame(payload, point, h)) {
+            points[point] = h;
+        }
+        raw.clear();
+    }
+
+    if (points.empty()) {
+        std::fprintf(stderr, "no profiler frames found (send 'Z' to the car)\n");
+        return 1;
+    }
+
+    std::printf("%-12s %10s %9s %9s %9s %9s\n", "point", "count", "p50 us", "p90 us", "p99 us", "max us");
+    for (const auto &entry : points) {
+        const Histogram &h = entry.second;
+        std::printf("%-12s %10u %9.0f %9.0f %9.0f %9u\n", h.name.c_str(), h.count,
+                    Percentile(h, 0.50), Percentile(h, 0.90), Percentile(h, 0.99), h.maxUs);
+    }
+
+    int status = 0;
+    for (const auto &budget : budgets) {
+        const Histogram *found = nullptr;
+        for (const auto &entry : points) {
+            if (entry.second.name == budget.first) {
+                found = &entry.second;
+            }
+        }
+        if (!found) {
+            std::printf("FAIL %s: not in capture\n", budget.first.c_str());
+            status = 2;
+            continue;
+        }
+        double p99 = Percentile(*found, 0.99);
+        bool ok = p99 <= budget.second;
+        std::printf("%s %s: p99 %.0f us, budget %u us\n", ok ? "ok  " : "FAIL", budget.first.c_str(),
+                    p99, budget.second);
+        if (!ok) {
+            status = 2;
+        }
+    }
+    return status;
+}
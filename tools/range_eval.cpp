@@ -0,0 +1,283 @@
+/**
+ * Host-side evaluation of the distance filter (see source/range_filter.h)
+ *
+ * Runs echo traces through the obstacle stop rule twice - on the raw
+ * samples (the old rule: first raw reading under the threshold stops)
+ * and through the firmware's own RangeFilter (estimate under the
+ * threshold with enough confidence) - and counts per trace:
+ *   false stop   stopped while the true distance was still >= threshold
+ *                + 10cm (nothing there yet)
+ *   missed stop  no stop before the true distance fell under half the
+ *                threshold (too late to brake: a collision)
+ *
+ * Traces are CSV, one sample per line: t_ms,raw_cm,truth_cm (raw_cm 0 =
+ * no echo; '#' lines are comments). Log them from the car with a tape
+ * measure or a known approach speed and pass the files on the command
+ * line. Without files a synthetic corpus is generated (fixed seed, so
+ * runs compare): approaches to a wall at several speeds, an open road
+ * with nothing in range, and an obstacle that appears in front of the
+ * car, each with clean / noisy / harsh sensors (spurious near echoes and
+ * dropouts).
+ *
+ * Exit status 2 if the filter misses more stops in total than the raw
+ * rule: rejecting ghosts must not cost collisions.
+ *
+ * Build:  g++ -std=c++17 -O2 -o range_eval tools/range_eval.cpp
+ * Usage:  range_eval [-n traces_per_case] [-t threshold_cm] [trace.csv]...
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+// Same filter code as the firmware (plain C, no hardware access)
+#include "../source/range_filter.c"
+
+namespace {
+
+constexpr uint32_t kPeriodMs = 50;          // ULTRASONIC_RANGING_PERIOD_MS
+constexpr unsigned kMinConfidence = 50;     // OBSTACLE_MIN_CONFIDENCE
+constexpr double kFalseMarginCm = 10;
+constexpr double kMaxRangeCm = 400;         // ULTRASONIC_MAX_DISTANCE_CM
+
+struct Sample {
+    uint32_t tMs;
+    uint32_t rawCm;     // 0 = no echo
+    double truthCm;
+};
+
+using Trace = std::vector<Sample>;
+
+struct Outcome {
+    bool falseStop = false;
+    bool missedStop = false;
+};
+
+struct Tally {
+    int traces = 0;
+    int obstacleTraces = 0;  // Truth reaches the miss line
+    int falseStops = 0;
+    int missedStops = 0;
+
+    void Add(const Outcome &o, bool obstacle)
+    {
+        traces++;
+        obstacleTraces += obstacle;
+        falseStops += o.falseStop;
+        missedStops += o.missedStop;
+    }
+};
+
+// Stop rule over one trace; filtered = through RangeFilter
+Outcome Evaluate(const Trace &trace, double thresholdCm, bool filtered)
+{
+    RangeFilter_t filter;
+    RangeFilter_Reset(&filter);
+    Outcome out;
+    uint32_t lastT = trace.empty() ? 0 : trace.front().tMs;
+
+    for (const Sample &s : trace) {
+        if (s.truthCm < thresholdCm / 2) {
+            out.missedStop = true;  // Got this close without stopping
+            return out;
+        }
+
+        bool stop;
+        if (filtered) {
+            RangeFilter_Update(&filter, s.rawCm, s.rawCm != 0, s.tMs - lastT);
+            stop = RangeFilter_Valid(&filter) && filter.confidence >= kMinConfidence &&
+                   filter.estimateCm < thresholdCm;
+        } else {
+            stop = s.rawCm != 0 && s.rawCm < thresholdCm;
+        }
+        lastT = s.tMs;
+
+        if (stop) {
+            out.falseStop = s.truthCm >= thresholdCm + kFalseMarginCm;
+            return out;
+        }
+    }
+    return out;
+}
+
+bool ReachesMissLine(const Trace &trace, double thresholdCm)
+{
+    for (const Sample &s : trace) {
+        if (s.truthCm < thresholdCm / 2) {
+            return true;
+        }
+    }
+    return false;
+}
+
+struct Noise {
+    const char *name;
+    double sigmaCm;     // Gaussian jitter
+    double spurious;    // Probability of a near ghost echo (3-30cm)
+    double dropout;     // Probability of no echo from a real target
+};
+
+const Noise kNoise[] = {
+    {"clean", 0.5, 0.0, 0.0},
+    {"noisy", 1.0, 0.03, 0.10},
+    {"harsh", 2.0, 0.08, 0.25},
+};
+
+// One echo of a target at truthCm (> kMaxRangeCm: nothing in range)
+uint32_t Echo(double truthCm, const Noise &noise, std::mt19937 &rng)
+{
+    std::uniform_real_distribution<double> u(0, 1);
+    std::normal_distribution<double> jitter(0, noise.sigmaCm);
+
+    if (u(rng) < noise.spurious) {
+        return 3 + static_cast<uint32_t>(u(rng) * 27);
+    }
+    if (truthCm > kMaxRangeCm || u(rng) < noise.dropout) {
+        return 0;
+    }
+    double raw = std::round(truthCm + jitter(rng));
+    return raw < 2 ? 2 : static_cast<uint32_t>(raw);
+}
+
+enum class Case { Approach, OpenRoad, Appear };
+
+// Synthetic trace: car at speedCmS, 20s at most
+Trace Generate(Case kind, double speedCmS, const Noise &noise, std::mt19937 &rng)
+{
+    std::uniform_real_distribution<double> u(0, 1);
+    Trace trace;
+    double start = 150 + u(rng) * 200;          // Wall distance at t = 0
+    double appearAt = 1000 + u(rng) * 4000;     // ms
+    double appearCm = 25 + u(rng) * 40;         // Distance it appears at
+
+    for (uint32_t t = 0; t < 20000; t += kPeriodMs) {
+        double truth;
+        switch (kind) {
+        case Case::Approach:
+            truth = start - speedCmS * t / 1000.0;
+            break;
+        case Case::OpenRoad:
+            truth = kMaxRangeCm + 100;
+            break;
+        default:
+            truth = (t < appearAt) ? kMaxRangeCm + 100 : appearCm - speedCmS * (t - appearAt) / 1000.0;
+            break;
+        }
+        trace.push_back({t, Echo(truth, noise, rng), truth});
+        if (truth <= 0) {
+            break;
+        }
+    }
+    return trace;
+}
+
+bool LoadTrace(const char *path, Trace &trace)
+{
+    FILE *f = std::fopen(path, "r");
+    if (!f) {
+        return false;
+    }
+    char line[128];
+    while (std::fgets(line, sizeof(line), f)) {
+        unsigned t, raw;
+        double truth;
+        if (line[0] != '#' && std::sscanf(line, "%u,%u,%lf", &t, &raw, &truth) == 3) {
+            trace.push_back({t, raw, truth});
+        }
+    }
+    std::fclose(f);
+    return true;
+}
+
+void PrintRow(const char *name, const Tally &raw, const Tally &filtered)
+{
+    auto pct = [](int n, int d) { return d ? 100.0 * n / d : 0.0; };
+    std::printf("%-24s %6d %9.1f%% %9.1f%% %9.1f%% %9.1f%%\n", name, raw.traces,
+                pct(raw.falseStops, raw.traces), pct(raw.missedStops, raw.obstacleTraces),
+                pct(filtered.falseStops, filtered.traces), pct(filtered.missedStops, filtered.obstacleTraces));
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    int perCase = 200;
+    double thresholdCm = 20;  // OBSTACLE_THRESHOLD_CM
+    std::vector<const char *> files;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            perCase = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            thresholdCm = std::atof(argv[++i]);
+        } else if (argv[i][0] == '-') {
+            std::fprintf(stderr, "usage: range_eval [-n traces_per_case] [-t threshold_cm] [trace.csv]...\n");
+            return 1;
+        } else {
+            files.push_back(argv[i]);
+        }
+    }
+
+    std::printf("%-24s %6s %10s %10s %10s %10s\n", "case", "traces", "raw false", "raw miss", "filt false",
+                "filt miss");
+
+    Tally rawTotal, filteredTotal;
+
+    if (!files.empty()) {
+        for (const char *path : files) {
+            Trace trace;
+            if (!LoadTrace(path, trace)) {
+                std::fprintf(stderr, "range_eval: cannot read %s\n", path);
+                return 1;
+            }
+            Tally raw, filtered;
+            bool obstacle = ReachesMissLine(trace, thresholdCm);
+            raw.Add(Evaluate(trace, thresholdCm, false), obstacle);
+            filtered.Add(Evaluate(trace, thresholdCm, true), obstacle);
+            PrintRow(path, raw, filtered);
+            rawTotal.Add(Evaluate(trace, thresholdCm, false), obstacle);
+            filteredTotal.Add(Evaluate(trace, thresholdCm, true), obstacle);
+        }
+    } else {
+        const struct {
+            Case kind;
+            const char *name;
+        } cases[] = {{Case::Approach, "approach"}, {Case::OpenRoad, "open road"}, {Case::Appear, "appears"}};
+        const double speeds[] = {20, 50, 100};
+        std::mt19937 rng(12345);
+
+        for (const auto &c : cases) {
+            for (const Noise &noise : kNoise) {
+                for (double speed : speeds) {
+                    Tally raw, filtered;
+                    for (int n = 0; n < perCase; n++) {
+                        Trace trace = Generate(c.kind, speed, noise, rng);
+                        bool obstacle = ReachesMissLine(trace, thresholdCm);
+                        Outcome r = Evaluate(trace, thresholdCm, false);
+                        Outcome f = Evaluate(trace, thresholdCm, true);
+                        raw.Add(r, obstacle);
+                        filtered.Add(f, obstacle);
+                        rawTotal.Add(r, obstacle);
+                        filteredTotal.Add(f, obstacle);
+                    }
+                    char name[64];
+                    std::snprintf(name, sizeof(name), "%s %s %.0fcm/s", c.name, noise.name, speed);
+                    PrintRow(name, raw, filtered);
+                }
+            }
+        }
+    }
+
+    PrintRow("total", rawTotal, filteredTotal);
+    std::printf("\nfalse: %% of traces; miss: %% of traces that reach %.0fcm\n", thresholdCm / 2);
+    if (filteredTotal.missedStops > rawTotal.missedStops) {
+        std::printf("FAIL: filter misses %d stops, raw rule %d\n", filteredTotal.missedStops, rawTotal.missedStops);
+        return 2;
+    }
+    std::printf("ok: filter misses %d stops, raw rule %d\n", filteredTotal.missedStops, rawTotal.missedStops);
+    return 0;
+}
@@ -0,0 +1,12 @@
+#ifndef MKL25Z4_H_HOST_STUB
+#define MKL25Z4_H_HOST_STUB
+
+/**
+ * Host stand-in for the device header
+ *
+ * Lets tools/ build firmware modules that include it (and the SDK
+ * headers next to it). Registers and SDK calls a module does use are
+ * defined by the tool itself, before it includes the module.
+ */
+
+#endif // MKL25Z4_H_HOST_STUB
@@ -0,0 +1,6 @@
+#ifndef FSL_CLOCK_H_HOST_STUB
+#define FSL_CLOCK_H_HOST_STUB
+
+// Host stand-in for the SDK clock driver (see MKL25Z4.h here)
+
+#endif // FSL_CLOCK_H_HOST_STUB
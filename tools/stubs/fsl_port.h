@@ -0,0 +1,6 @@
+#ifndef FSL_PORT_H_HOST_STUB
+#define FSL_PORT_H_HOST_STUB
+
+// Host stand-in for the SDK header (see MKL25Z4.h here)
+
+#endif // FSL_PORT_H_HOST_STUB